@@ -0,0 +1,34 @@
+// aligned_allocator.cpp
+#include "aligned_allocator.hpp"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace aligned_memory {
+
+namespace {
+
+size_t alignmentFor(size_t bytes) {
+    return bytes >= HugePageBytes ? HugePageBytes : CacheLineBytes;
+}
+
+} // namespace
+
+void* allocate(size_t bytes) {
+    const size_t alignment = alignmentFor(bytes);
+    void* p = ::operator new(bytes, std::align_val_t(alignment));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (alignment == HugePageBytes) {
+        // Only whole huge pages inside the block can be advised
+        madvise(p, bytes & ~(HugePageBytes - 1), MADV_HUGEPAGE);
+    }
+#endif
+    return p;
+}
+
+void deallocate(void* p, size_t bytes) noexcept {
+    ::operator delete(p, std::align_val_t(alignmentFor(bytes)));
+}
+
+} // namespace aligned_memory
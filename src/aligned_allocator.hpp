@@ -0,0 +1,47 @@
+// aligned_allocator.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+// Cache-line memory for the large CA grids. Every block is 64-byte aligned,
+// so a 512-bit load of the grid never splits a cache line; blocks of
+// HugePageBytes or more are aligned to a huge page and the kernel is asked
+// to back them with transparent huge pages, which cuts TLB misses on
+// multi-GB grids. The advice is a hint: without THP it is silently ignored.
+namespace aligned_memory {
+
+constexpr size_t CacheLineBytes = 64;
+constexpr size_t HugePageBytes = size_t(2) << 20;
+
+void* allocate(size_t bytes);
+void deallocate(void* p, size_t bytes) noexcept;
+
+} // namespace aligned_memory
+
+template <typename T>
+class AlignedAllocator {
+public:
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) throw std::bad_array_new_length();
+        return static_cast<T*>(aligned_memory::allocate(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        aligned_memory::deallocate(p, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U>&) const noexcept { return false; }
+};
+
+// Packed cell words of a CA grid
+using CellWords = std::vector<uint64_t, AlignedAllocator<uint64_t>>;
@@ -0,0 +1,111 @@
+// bit_utils.hpp
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <stdlib.h>
+#endif
+
+// Small portable helpers shared by the packed bit containers and the CA kernels.
+// Packed buffers in this project keep bits in stream order: bit 0 is the MSB of
+// byte 0, so a file can be loaded with a plain memcpy and a 64-bit big-endian
+// load yields 64 consecutive bits with the earliest one in the top position.
+
+inline unsigned popcount64(uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<unsigned>(__popcnt64(x));
+#elif defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<unsigned>((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Index of the lowest set bit; x must be non-zero
+inline unsigned countTrailingZeros64(uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<unsigned>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+    unsigned n = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+inline uint64_t byteSwap64(uint64_t x) {
+#if defined(_MSC_VER)
+    return _byteswap_uint64(x);
+#else
+    return __builtin_bswap64(x);
+#endif
+}
+
+// Load/store 64 stream-ordered bits (assumes a little-endian host, as the
+// rest of the SIMD code does)
+inline uint64_t loadBigEndian64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return byteSwap64(v);
+}
+
+inline void storeBigEndian64(uint8_t* p, uint64_t v) {
+    v = byteSwap64(v);
+    std::memcpy(p, &v, sizeof(v));
+}
+
+// Reverse the bit order within each byte of x
+inline uint64_t reverseBitsInBytes64(uint64_t x) {
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    return x;
+}
+
+inline uint8_t reverseBits8(uint8_t b) {
+    return static_cast<uint8_t>(reverseBitsInBytes64(b));
+}
+
+inline uint64_t reverseBits64(uint64_t x) {
+    return reverseBitsInBytes64(byteSwap64(x));
+}
+
+// Per-byte steps of the +/-1 random walk used by the cumulative-sum style
+// tests: the byte's net change and the highest and lowest partial sums
+// reached within it (counting the start at 0)
+struct ByteWalkTable {
+    int8_t delta[256];
+    int8_t prefixMax[256];
+    int8_t prefixMin[256];
+
+    ByteWalkTable() {
+        for (int b = 0; b < 256; b++) {
+            int s = 0, hi = 0, lo = 0;
+            for (int k = 7; k >= 0; k--) {
+                s += ((b >> k) & 1) ? 1 : -1;
+                hi = s > hi ? s : hi;
+                lo = s < lo ? s : lo;
+            }
+            delta[b] = static_cast<int8_t>(s);
+            prefixMax[b] = static_cast<int8_t>(hi);
+            prefixMin[b] = static_cast<int8_t>(lo);
+        }
+    }
+};
+
+inline const ByteWalkTable& byteWalkTable() {
+    static const ByteWalkTable table;
+    return table;
+}
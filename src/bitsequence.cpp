@@ -1,102 +1,466 @@
 // bitsequence.cpp
-#include "test_suite.hpp"
 #include "bitsequence.hpp"
+#include "bit_utils.hpp"
+#include "mapped_file.hpp"
+#include "input_decoders.hpp"
+#include "simd_kernels.hpp"
 #include <stdexcept>
 #include <algorithm>
+#include <cstring>
 
 namespace nist_sts {
 
-BitSequence::BitSequence(size_t size) : bits(size) {}
+BitSequence::BitSequence(size_t size)
+    : words(std::make_shared<std::vector<uint64_t>>(size / 64 + 2, 0)), bitCount(size) {}
 
-BitSequence::BitSequence(const std::vector<bool>& data) : bits(data) {}
-
-BitSequence BitSequence::fromBinaryFile(const std::string& filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file) {
-        throw std::runtime_error("Cannot open file: " + filename);
+BitSequence::BitSequence(const std::vector<bool>& data) : BitSequence(data.size()) {
+    for (size_t i = 0; i < data.size(); i++) {
+        if (data[i]) setBit(i, true);
     }
-    
+}
+
+BitSequence BitSequence::fromBytes(const uint8_t* data, size_t count) {
     BitSequence result;
-    char byte;
-    while (file.get(byte)) {
-        for (int i = 7; i >= 0; --i) {
-            result.push_back((byte >> i) & 1);
-        }
+    result.appendBytes(data, count);
+    return result;
+}
+
+BitSequence BitSequence::fromBytes(const std::vector<uint8_t>& data) {
+    return fromBytes(data.data(), data.size());
+}
+
+BitSequence BitSequence::view(ByteSpan data, std::shared_ptr<const void> owner) {
+    return view(data.data(), data.size() * 8, std::move(owner));
+}
+
+BitSequence BitSequence::view(const uint8_t* data, size_t bitCount,
+                              std::shared_ptr<const void> owner) {
+    BitSequence result;
+    if (data == nullptr || bitCount == 0) return result;
+    result.viewData = data;
+    result.viewBytes = (bitCount + 7) / 8;
+    result.bitCount = bitCount;
+    result.owner = std::move(owner);
+    return result;
+}
+
+BitSequence BitSequence::view(const ByteView& data, std::shared_ptr<const void> owner) {
+    if (data.isContiguous()) {
+        return view(data.contiguousSpan(), std::move(owner));
     }
-    
+    BitSequence result = view(data.sourceBytes(), std::move(owner));
+    result.bitCount = data.size() * 8;
+    result.layout.base = data.firstIndex() * 8;
+    result.layout.unitStep = data.stride() * 8;
+    result.layout.unitBits = 8;
+    result.layout.lsbFirst = data.isBitReversed();
+    result.layout.complemented = data.isComplemented();
     return result;
 }
 
+BitSequence BitSequence::fromBinaryFile(const std::string& filename) {
+    // The packed layout matches the file layout, so no decoding is needed
+    // (LSB-first captures can be read through reverseBitOrder())
+    return fromMappedFile(filename);
+}
+
+BitSequence BitSequence::fromMappedFile(const std::string& filename) {
+    auto file = std::make_shared<MappedFile>(filename);
+    ByteSpan bytes = file->bytes();
+    return view(bytes, std::move(file));
+}
+
 BitSequence BitSequence::fromAsciiFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file) {
-        throw std::runtime_error("Cannot open file: " + filename);
+    MappedFile file(filename);
+    size_t bits = 0;
+    std::vector<uint8_t> packed = InputDecoder::decodeAsciiBits(file.bytes(), bits);
+
+    BitSequence result = fromBytes(packed);
+    result.resize(bits);
+    return result;
+}
+
+void BitSequence::detach() {
+    if (!isPlain()) {
+        // Materialize the transformed bits into owned words
+        auto owned = std::make_shared<std::vector<uint64_t>>(bitCount / 64 + 2, 0);
+        uint8_t* p = reinterpret_cast<uint8_t*>(owned->data());
+        for (size_t w = 0; w * 64 < bitCount; w++) {
+            storeBigEndian64(p + w * 8, getWord(w));
+        }
+        words = std::move(owned);
+        viewData = nullptr;
+        viewBytes = 0;
+        owner.reset();
+        layout = BitLayout{};
+        return;
     }
-    
-    BitSequence result;
-    char bit;
-    while (file.get(bit)) {
-        if (bit == '0') {
-            result.push_back(false);
-        } else if (bit == '1') {
-            result.push_back(true);
+    if (!viewData) {
+        // Copy-on-write: other sequences still read these words
+        if (words.use_count() > 1) {
+            words = std::make_shared<std::vector<uint64_t>>(*words);
         }
-        // Ignore other characters (whitespace, etc.)
+        return;
     }
-    
-    return result;
+    auto owned = std::make_shared<std::vector<uint64_t>>(bitCount / 64 + 2, 0);
+    std::memcpy(owned->data(), viewData, byteCount());
+    words = std::move(owned);
+    viewData = nullptr;
+    viewBytes = 0;
+    owner.reset();
+    clearTail();
+}
+
+void BitSequence::reserveBits(size_t n) {
+    detach();
+    // Always keep one zero guard word past the last used word
+    size_t needed = n / 64 + 2;
+    if (words->size() < needed) {
+        words->resize(std::max(needed, words->size() * 2), 0);
+    }
+}
+
+void BitSequence::clearTail() {
+    size_t usedBytes = byteCount();
+    uint8_t* p = byteData();
+    std::memset(p + usedBytes, 0, words->size() * 8 - usedBytes);
+    if (bitCount & 7) {
+        p[bitCount >> 3] &= static_cast<uint8_t>(0xFF00 >> (bitCount & 7));
+    }
+}
+
+void BitSequence::setBit(size_t index, bool value) {
+    uint8_t mask = static_cast<uint8_t>(0x80 >> (index & 7));
+    uint8_t& byte = byteData()[index >> 3];
+    byte = value ? (byte | mask) : (byte & ~mask);
 }
 
 bool BitSequence::operator[](size_t index) const {
-    return bits[index];
+    if (isPlain()) {
+        return (bytes()[index >> 3] >> (7 - (index & 7))) & 1;
+    }
+    size_t p = physicalIndex(index);
+    unsigned shift = layout.lsbFirst ? (p & 7) : 7 - (p & 7);
+    return (((bytes()[p >> 3] >> shift) & 1) != 0) != layout.complemented;
 }
 
 BitReference BitSequence::operator[](size_t index) {
-    return BitReference(bits, index);
+    return BitReference(*this, index);
 }
 
 size_t BitSequence::size() const {
-    return bits.size();
+    return bitCount;
 }
 
 void BitSequence::resize(size_t newSize) {
-    bits.resize(newSize);
+    reserveBits(newSize);
+    bitCount = newSize;
+    clearTail();
 }
 
 void BitSequence::push_back(bool bit) {
-    bits.push_back(bit);
+    reserveBits(bitCount + 1);
+    if (bit) setBit(bitCount, true);
+    bitCount++;
+}
+
+void BitSequence::appendBits(uint64_t value, unsigned count) {
+    if (count == 0) return;
+    if (count < 64) value &= (1ULL << count) - 1;
+    reserveBits(bitCount + count);
+
+    uint8_t* p = byteData();
+    while (count > 0) {
+        unsigned offset = bitCount & 7;
+        unsigned take = std::min(8u - offset, count);
+        uint8_t chunk = static_cast<uint8_t>((value >> (count - take)) & ((1u << take) - 1));
+        p[bitCount >> 3] |= static_cast<uint8_t>(chunk << (8 - offset - take));
+        bitCount += take;
+        count -= take;
+    }
+}
+
+void BitSequence::appendBytes(const uint8_t* data, size_t count) {
+    if (count == 0) return;
+    reserveBits(bitCount + count * 8);
+
+    if ((bitCount & 7) == 0) {
+        std::memcpy(byteData() + (bitCount >> 3), data, count);
+        bitCount += count * 8;
+        return;
+    }
+
+    // Unaligned destination: shift each source byte across two bytes
+    uint8_t* p = byteData() + (bitCount >> 3);
+    unsigned shift = bitCount & 7;
+    for (size_t i = 0; i < count; i++) {
+        p[i] |= static_cast<uint8_t>(data[i] >> shift);
+        p[i + 1] = static_cast<uint8_t>(data[i] << (8 - shift));
+    }
+    bitCount += count * 8;
+}
+
+void BitSequence::append(const BitSequence& other) {
+    if (&other == this) {
+        BitSequence copy = other;  // shares storage until we write
+        append(copy);
+        return;
+    }
+    if (!other.isPlain()) {
+        for (size_t pos = 0; pos < other.size(); pos += 64) {
+            unsigned take = static_cast<unsigned>(std::min<size_t>(64, other.size() - pos));
+            appendBits(other.getBits(pos, take), take);
+        }
+        return;
+    }
+    size_t fullBytes = other.size() / 8;
+    appendBytes(other.bytes(), fullBytes);
+    unsigned rest = other.size() & 7;
+    if (rest) {
+        appendBits(other.getBits(fullBytes * 8, rest), rest);
+    }
+}
+
+uint64_t BitSequence::getWord(size_t wordIndex) const {
+    size_t pos = wordIndex * 64;
+    if (isPlain() && pos + 64 <= bitCount) {
+        return loadBigEndian64(bytes() + wordIndex * 8);
+    }
+    if (pos >= bitCount) return 0;
+    unsigned count = static_cast<unsigned>(std::min<size_t>(64, bitCount - pos));
+    return getBits(pos, count) << (64 - count);
+}
+
+uint8_t BitSequence::getByte(size_t byteIndex) const {
+    size_t pos = byteIndex * 8;
+    if (isPlain() && pos + 8 <= bitCount) {
+        return bytes()[byteIndex];
+    }
+    if (pos >= bitCount) return 0;
+    unsigned count = static_cast<unsigned>(std::min<size_t>(8, bitCount - pos));
+    return static_cast<uint8_t>(getBits(pos, count) << (8 - count));
+}
+
+uint64_t BitSequence::getBits(size_t pos, unsigned count) const {
+    return isPlain() ? physicalBits(pos, count) : transformedBits(pos, count);
+}
+
+uint64_t BitSequence::physicalBits(size_t pos, unsigned count) const {
+    if (count == 0) return 0;
+    const uint8_t* p = bytes() + (pos >> 3);
+
+    // Views have no guard word, so reads near their end go through a copy;
+    // LSB-first storage is flipped to stream order in the same buffer
+    uint8_t edge[9] = {0};
+    size_t available = storageBytes() - (pos >> 3);
+    if (available < 9 || layout.lsbFirst) {
+        std::memcpy(edge, p, std::min<size_t>(available, 9));
+        if (layout.lsbFirst) {
+            for (auto& b : edge) b = reverseBits8(b);
+        }
+        p = edge;
+    }
+
+    unsigned shift = pos & 7;
+    uint64_t v = loadBigEndian64(p);
+    if (shift) {
+        v = (v << shift) | (p[8] >> (8 - shift));
+    }
+    return v >> (64 - count);
+}
+
+uint64_t BitSequence::transformedBits(size_t pos, unsigned count) const {
+    // Split the request into runs that are contiguous in storage (the whole
+    // request for a +/-1 stride, one unit for byte decimation, one bit
+    // otherwise) and read each run forwards or backwards
+    const bool contiguous = layout.unitBits == 1 && (layout.unitStep == 1 || layout.unitStep == -1);
+    uint64_t v = 0;
+    size_t i = pos;
+    unsigned remaining = count;
+    while (remaining > 0) {
+        unsigned run = 1;
+        ptrdiff_t direction = 1;
+        if (contiguous) {
+            run = remaining;
+            direction = layout.unitStep;
+        } else if (layout.unitBits > 1) {
+            run = static_cast<unsigned>(std::min<size_t>(remaining, layout.unitBits - i % layout.unitBits));
+            direction = layout.bitStep;
+        }
+
+        size_t p = physicalIndex(i);
+        uint64_t bits = (direction > 0)
+            ? physicalBits(p, run)
+            : reverseBits64(physicalBits(p - (run - 1), run)) >> (64 - run);
+        v = (run == 64) ? bits : ((v << run) | bits);
+        i += run;
+        remaining -= run;
+    }
+    if (layout.complemented) {
+        v ^= (count == 64) ? ~0ULL : ((1ULL << count) - 1);
+    }
+    return v;
 }
 
 size_t BitSequence::countOnes() const {
-    return std::count(bits.begin(), bits.end(), true);
+    return countOnes(0, bitCount);
+}
+
+size_t BitSequence::countOnes(size_t pos, size_t length) const {
+    if (length == 0) return 0;
+    if (layout.unitBits == 1 && (layout.unitStep == 1 || layout.unitStep == -1)) {
+        // A forward or reversed range is one physical range
+        size_t first = (layout.unitStep == 1) ? physicalIndex(pos) : physicalIndex(pos + length - 1);
+        size_t ones = physicalCountOnes(first, length);
+        return layout.complemented ? length - ones : ones;
+    }
+    size_t total = 0;
+    for (; length > 0;) {
+        unsigned take = static_cast<unsigned>(std::min<size_t>(length, 64));
+        total += popcount64(getBits(pos, take));
+        pos += take;
+        length -= take;
+    }
+    return total;
+}
+
+size_t BitSequence::physicalCountOnes(size_t pos, size_t length) const {
+    size_t total = 0;
+    while (length > 0 && (pos & 63)) {
+        unsigned take = static_cast<unsigned>(std::min<size_t>(length, 64 - (pos & 63)));
+        total += popcount64(physicalBits(pos, take));
+        pos += take;
+        length -= take;
+    }
+    const uint8_t* p = bytes();
+    if (length >= 64 && simdLevel() >= SimdLevel::AVX2) {
+        uint64_t ones = 0;
+        size_t words = simd_kernels::popcountAvx2(p + (pos >> 3), 0, length / 64, ones);
+        total += ones;
+        pos += words * 64;
+        length -= words * 64;
+    }
+    for (; length >= 64; pos += 64, length -= 64) {
+        uint64_t w;
+        std::memcpy(&w, p + (pos >> 3), sizeof(w));  // byte and bit order do not matter here
+        total += popcount64(w);
+    }
+    if (length > 0) {
+        total += popcount64(physicalBits(pos, static_cast<unsigned>(length)));
+    }
+    return total;
+}
+
+BitSequence BitSequence::reverse() const {
+    BitSequence result = *this;
+    if (bitCount == 0) return result;
+    if (layout.unitBits > 1 && bitCount % layout.unitBits != 0) {
+        // Partial final unit: the affine form no longer fits
+        result.detach();
+        return result.reverse();
+    }
+    // The last bit becomes the first and both strides flip
+    result.layout.base = physicalIndex(bitCount - 1);
+    result.layout.unitStep = -layout.unitStep;
+    result.layout.bitStep = -layout.bitStep;
+    return result;
+}
+
+BitSequence BitSequence::complement() const {
+    BitSequence result = *this;
+    result.layout.complemented = !layout.complemented;
+    return result;
+}
+
+BitSequence BitSequence::reverseBitOrder() const {
+    BitSequence result = *this;
+    result.layout.lsbFirst = !layout.lsbFirst;
+    return result;
+}
+
+BitSequence BitSequence::decimate(size_t k, size_t phase) const {
+    if (k == 0) {
+        throw std::runtime_error("Decimation factor must be positive");
+    }
+    BitSequence result = *this;
+    if (phase >= bitCount) {
+        result.bitCount = 0;
+        return result;
+    }
+    if (layout.unitBits != 1) {
+        result.detach();
+        return result.decimate(k, phase);
+    }
+    result.layout.base = physicalIndex(phase);
+    result.layout.unitStep = layout.unitStep * static_cast<ptrdiff_t>(k);
+    result.bitCount = (bitCount - phase + k - 1) / k;
+    return result;
+}
+
+BitSequence BitSequence::decimateBytes(size_t k, size_t phase) const {
+    if (k == 0) {
+        throw std::runtime_error("Decimation factor must be positive");
+    }
+    BitSequence result = *this;
+    size_t units = bitCount / 8;
+    if (phase >= units) {
+        result.bitCount = 0;
+        return result;
+    }
+    if (layout.unitBits == 1 && (layout.unitStep == 1 || layout.unitStep == -1)) {
+        result.layout.unitBits = 8;
+        result.layout.bitStep = layout.unitStep;
+        result.layout.unitStep = layout.unitStep * 8 * static_cast<ptrdiff_t>(k);
+    } else if (layout.unitBits == 8) {
+        result.layout.unitStep = layout.unitStep * static_cast<ptrdiff_t>(k);
+    } else {
+        result.detach();
+        return result.decimateBytes(k, phase);
+    }
+    result.layout.base = physicalIndex(phase * 8);
+    result.bitCount = (units - phase + k - 1) / k * 8;
+    return result;
+}
+
+BitSequence BitSequence::slice(size_t pos, size_t length) const {
+    pos = std::min(pos, bitCount);
+    length = std::min(length, bitCount - pos);
+    BitSequence result = *this;
+    if (pos % layout.unitBits != 0) {
+        result.detach();
+        return result.slice(pos, length);
+    }
+    result.layout.base = physicalIndex(pos);
+    result.bitCount = length;
+    return result;
 }
 
 size_t BitSequence::countZeros() const {
-    return std::count(bits.begin(), bits.end(), false);
+    return bitCount - countOnes();
 }
 
 BitSequence::iterator BitSequence::begin() {
-    return bits.begin();
+    return iterator(this, 0);
 }
 
 BitSequence::iterator BitSequence::end() {
-    return bits.end();
+    return iterator(this, bitCount);
 }
 
 BitSequence::const_iterator BitSequence::begin() const {
-    return bits.begin();
+    return const_iterator(this, 0);
 }
 
 BitSequence::const_iterator BitSequence::end() const {
-    return bits.end();
+    return const_iterator(this, bitCount);
 }
 
 BitSequence::const_iterator BitSequence::cbegin() const {
-    return bits.cbegin();
+    return const_iterator(this, 0);
 }
 
 BitSequence::const_iterator BitSequence::cend() const {
-    return bits.cend();
+    return const_iterator(this, bitCount);
 }
 
-} // namespace nist_sts
\ No newline at end of file
+} // namespace nist_sts
@@ -2,55 +2,234 @@
 #pragma once
 #include <vector>
 #include <cstddef>
+#include <cstdint>
 #include <fstream>
 #include <string>
+#include <iterator>
+#include <memory>
+#include "byte_span.hpp"
+#include "byte_view.hpp"
 
 namespace nist_sts {
 
 // Forward declaration of our custom reference class
 class BitReference;
 
+// Packed bit sequence.
+//
+// Bits are stored 64 to a word in stream byte order: bit i lives in byte i/8
+// at position 7 - i%8, exactly as it appears in a binary file. getWord() and
+// getBits() return MSB-first values, so the earliest bit is the most
+// significant one. Bits past size() read as zero, and owned storage keeps one
+// zero guard word past the end so window reads never need bounds checks.
+//
+// Copies share their storage: the words are reference-counted and only
+// duplicated when a copy is modified, so one decoded sequence can be handed
+// to every test without further allocation. A BitSequence can also be a
+// read-only view of packed bytes owned elsewhere (e.g. a memory-mapped file);
+// `owner` keeps that memory alive, and the first modification copies the
+// bits into owned words.
+//
+// Transforms (reverse, complement, bit order, decimation, slicing) return
+// lazily evaluated views that share the same storage; every accessor honours
+// them, so tests can run on a transformed sequence without it being copied.
+// bytes() always refers to the untransformed storage; see isPlain().
 class BitSequence {
+public:
+    // Logical bit i of a sequence is physical storage bit
+    //   base + unitStep * (i / unitBits) + bitStep * (i % unitBits)
+    // where physical bit p is bit 7 - p%8 of byte p/8 (bit p%8 if lsbFirst),
+    // inverted when `complemented` is set. unitBits is 1, or 8 once bytes
+    // have been decimated.
+    struct BitLayout {
+        size_t base = 0;
+        ptrdiff_t unitStep = 1;
+        ptrdiff_t bitStep = 1;
+        unsigned unitBits = 1;
+        bool lsbFirst = false;
+        bool complemented = false;
+
+        bool operator==(const BitLayout& o) const {
+            return base == o.base && unitStep == o.unitStep && bitStep == o.bitStep &&
+                   unitBits == o.unitBits && lsbFirst == o.lsbFirst && complemented == o.complemented;
+        }
+        bool operator!=(const BitLayout& o) const { return !(*this == o); }
+    };
+
 private:
-    std::vector<bool> bits;
-    
+    std::shared_ptr<std::vector<uint64_t>> words;  // shared until written
+    size_t bitCount = 0;
+
+    // View state
+    const uint8_t* viewData = nullptr;
+    size_t viewBytes = 0;
+    std::shared_ptr<const void> owner;
+
+    BitLayout layout;
+
+    size_t physicalIndex(size_t i) const {
+        return static_cast<size_t>(static_cast<ptrdiff_t>(layout.base) +
+                                   layout.unitStep * static_cast<ptrdiff_t>(i / layout.unitBits) +
+                                   layout.bitStep * static_cast<ptrdiff_t>(i % layout.unitBits));
+    }
+    uint64_t physicalBits(size_t pos, unsigned count) const;
+    size_t physicalCountOnes(size_t pos, size_t length) const;
+    uint64_t transformedBits(size_t pos, unsigned count) const;
+
+    size_t storageBytes() const { return viewData ? viewBytes : words->size() * 8; }
+    uint8_t* byteData() { detach(); return reinterpret_cast<uint8_t*>(words->data()); }
+    void detach();
+    void reserveBits(size_t n);
+    void clearTail();
+    void setBit(size_t index, bool value);
+
 public:
     // Constructors
     BitSequence(size_t size = 0);
     BitSequence(const std::vector<bool>& data);
-    
-    // Create from file
+
+    // Create from packed bytes (MSB-first within each byte)
+    static BitSequence fromBytes(const uint8_t* data, size_t count);
+    static BitSequence fromBytes(const std::vector<uint8_t>& data);
+
+    // Zero-copy view of packed bytes; `owner` (if any) is held until the last
+    // copy of the view goes away
+    static BitSequence view(ByteSpan data, std::shared_ptr<const void> owner = nullptr);
+    static BitSequence view(const uint8_t* data, size_t bitCount,
+                            std::shared_ptr<const void> owner = nullptr);
+    static BitSequence view(const ByteView& data, std::shared_ptr<const void> owner = nullptr);
+
+    // Create from file. Binary files are memory-mapped and viewed in place;
+    // ASCII files hold '0'/'1' characters and whitespace.
     static BitSequence fromBinaryFile(const std::string& filename);
+    static BitSequence fromMappedFile(const std::string& filename);
     static BitSequence fromAsciiFile(const std::string& filename);
-    
+
     // Element access - const version returns bool
     bool operator[](size_t index) const;
-    
+
     // Non-const version returns our custom reference
     BitReference operator[](size_t index);
-    
+
     // Capacity
     size_t size() const;
     void resize(size_t newSize);
-    
+
     // Modifiers
     void push_back(bool bit);
-    
+
+    // Bulk append
+    void appendBits(uint64_t value, unsigned count);     // low `count` bits, MSB first
+    void appendBytes(const uint8_t* data, size_t count);
+    void append(const BitSequence& other);
+
+    // Packed access
+    size_t wordCount() const { return (bitCount + 63) / 64; }
+    size_t byteCount() const { return (bitCount + 7) / 8; }
+    const uint8_t* bytes() const {
+        return viewData ? viewData : reinterpret_cast<const uint8_t*>(words->data());
+    }
+    bool isView() const { return viewData != nullptr; }
+
+    // Lazy transforms; the result shares this sequence's storage
+    BitSequence reverse() const;
+    BitSequence complement() const;
+    BitSequence reverseBitOrder() const;                        // LSB-first within each byte
+    BitSequence decimate(size_t k, size_t phase = 0) const;      // every k-th bit
+    BitSequence decimateBytes(size_t k, size_t phase = 0) const; // every k-th 8-bit group
+    BitSequence slice(size_t pos, size_t length) const;
+
+    // True when logical bit i is bit i of bytes() in stream order
+    bool isPlain() const { return layout == BitLayout{}; }
+    const BitLayout& getLayout() const { return layout; }
+
+    uint64_t getWord(size_t wordIndex) const;             // bits [64w, 64w + 64)
+    uint8_t getByte(size_t byteIndex) const;              // bits [8b, 8b + 8)
+    uint64_t getBits(size_t pos, unsigned count) const;   // count <= 64, right-aligned
+
     // Statistics
     size_t countOnes() const;
+    size_t countOnes(size_t pos, size_t length) const;
     size_t countZeros() const;
-    
+
     // Iterator support
-    using iterator = std::vector<bool>::iterator;
-    using const_iterator = std::vector<bool>::const_iterator;
-    
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = bool;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = bool;
+
+        const_iterator(const BitSequence* seq = nullptr, size_t pos = 0) : seq(seq), pos(pos) {}
+        bool operator*() const { return (*seq)[pos]; }
+        const_iterator& operator++() { ++pos; return *this; }
+        const_iterator operator++(int) { const_iterator tmp = *this; ++pos; return tmp; }
+        const_iterator& operator--() { --pos; return *this; }
+        const_iterator operator--(int) { const_iterator tmp = *this; --pos; return tmp; }
+        const_iterator& operator+=(difference_type n) { pos += n; return *this; }
+        const_iterator& operator-=(difference_type n) { pos -= n; return *this; }
+        const_iterator operator+(difference_type n) const { return const_iterator(seq, pos + n); }
+        const_iterator operator-(difference_type n) const { return const_iterator(seq, pos - n); }
+        friend const_iterator operator+(difference_type n, const const_iterator& it) { return it + n; }
+        difference_type operator-(const const_iterator& other) const {
+            return static_cast<difference_type>(pos) - static_cast<difference_type>(other.pos);
+        }
+        bool operator[](difference_type n) const { return *(*this + n); }
+        bool operator==(const const_iterator& other) const { return pos == other.pos; }
+        bool operator!=(const const_iterator& other) const { return pos != other.pos; }
+        bool operator<(const const_iterator& other) const { return pos < other.pos; }
+        bool operator>(const const_iterator& other) const { return pos > other.pos; }
+        bool operator<=(const const_iterator& other) const { return pos <= other.pos; }
+        bool operator>=(const const_iterator& other) const { return pos >= other.pos; }
+
+    private:
+        const BitSequence* seq;
+        size_t pos;
+    };
+
+    class iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = bool;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = BitReference;
+
+        iterator(BitSequence* seq = nullptr, size_t pos = 0) : seq(seq), pos(pos) {}
+        BitReference operator*() const;
+        iterator& operator++() { ++pos; return *this; }
+        iterator operator++(int) { iterator tmp = *this; ++pos; return tmp; }
+        iterator& operator--() { --pos; return *this; }
+        iterator operator--(int) { iterator tmp = *this; --pos; return tmp; }
+        iterator& operator+=(difference_type n) { pos += n; return *this; }
+        iterator& operator-=(difference_type n) { pos -= n; return *this; }
+        iterator operator+(difference_type n) const { return iterator(seq, pos + n); }
+        iterator operator-(difference_type n) const { return iterator(seq, pos - n); }
+        friend iterator operator+(difference_type n, const iterator& it) { return it + n; }
+        difference_type operator-(const iterator& other) const {
+            return static_cast<difference_type>(pos) - static_cast<difference_type>(other.pos);
+        }
+        BitReference operator[](difference_type n) const;
+        bool operator==(const iterator& other) const { return pos == other.pos; }
+        bool operator!=(const iterator& other) const { return pos != other.pos; }
+        bool operator<(const iterator& other) const { return pos < other.pos; }
+        bool operator>(const iterator& other) const { return pos > other.pos; }
+        bool operator<=(const iterator& other) const { return pos <= other.pos; }
+        bool operator>=(const iterator& other) const { return pos >= other.pos; }
+
+    private:
+        BitSequence* seq;
+        size_t pos;
+    };
+
     iterator begin();
     iterator end();
     const_iterator begin() const;
     const_iterator end() const;
     const_iterator cbegin() const;
     const_iterator cend() const;
-    
+
     // Give BitReference access to private members
     friend class BitReference;
 };
@@ -58,28 +237,43 @@ public:
 // Custom reference class for non-const operator[]
 class BitReference {
 private:
-    std::vector<bool>& bits;
+    BitSequence& seq;
     size_t index;
-    
+
 public:
-    BitReference(std::vector<bool>& bits, size_t index) : bits(bits), index(index) {}
-    
+    BitReference(BitSequence& seq, size_t index) : seq(seq), index(index) {}
+
     // Conversion operator to bool
     operator bool() const {
-        return bits[index];
+        return static_cast<const BitSequence&>(seq)[index];
     }
-    
+
     // Assignment operator
     BitReference& operator=(bool value) {
-        bits[index] = value;
+        seq.setBit(index, value);
         return *this;
     }
-    
+
     // Assignment operator for BitReference
     BitReference& operator=(const BitReference& other) {
-        bits[index] = other.bits[other.index];
+        seq.setBit(index, static_cast<bool>(other));
         return *this;
     }
+
+    // Swaps the referenced bits, so mutating algorithms work on iterators
+    friend void swap(BitReference a, BitReference b) {
+        bool tmp = a;
+        a = static_cast<bool>(b);
+        b = tmp;
+    }
 };
 
-} // namespace nist_sts
\ No newline at end of file
+inline BitReference BitSequence::iterator::operator*() const {
+    return BitReference(*seq, pos);
+}
+
+inline BitReference BitSequence::iterator::operator[](difference_type n) const {
+    return BitReference(*seq, pos + n);
+}
+
+} // namespace nist_sts
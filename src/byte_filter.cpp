@@ -0,0 +1,200 @@
+#include "byte_filter.hpp"
+#include "cpu_features.hpp"
+#include "simd_kernels.hpp"
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace {
+
+struct KindName {
+    ByteFilter::Kind kind;
+    const char* name;
+};
+
+constexpr KindName KindNames[] = {
+    {ByteFilter::Kind::Median, "median"}, {ByteFilter::Kind::Min, "min"},
+    {ByteFilter::Kind::Max, "max"},       {ByteFilter::Kind::Open, "open"},
+    {ByteFilter::Kind::Close, "close"}};
+
+// Cell i of a line of n cells, reflected about both ends (-1 reads as 0)
+size_t mirror(long long i, size_t n) {
+    const long long period = 2 * static_cast<long long>(n);
+    i %= period;
+    if (i < 0) i += period;
+    return static_cast<size_t>(i < static_cast<long long>(n) ? i : period - 1 - i);
+}
+
+struct PickMin {
+    uint8_t operator()(uint8_t a, uint8_t b) const { return std::min(a, b); }
+};
+
+struct PickMax {
+    uint8_t operator()(uint8_t a, uint8_t b) const { return std::max(a, b); }
+};
+
+// out[i] = median of padded[i, i + window) for i in [first, last), by
+// Huang's method: the window's histogram gains one byte and loses one per
+// step, and the median moves from its last value, with `below` counting the
+// window bytes less than it. simd_kernels::runningMedianSse2 replaces the
+// walk with a lookup in a two-level histogram.
+void runningMedian(const uint8_t* padded, uint8_t* out, size_t first, size_t last, size_t window) {
+    if (first >= last) return;
+    const size_t rank = window / 2;
+    size_t histogram[256] = {};
+    for (size_t j = 0; j < window; j++) histogram[padded[first + j]]++;
+
+    unsigned value = 0;
+    size_t below = 0;
+    for (size_t i = first; i < last; i++) {
+        if (i > first) {
+            uint8_t in = padded[i + window - 1], gone = padded[i - 1];
+            histogram[in]++;
+            if (in < value) below++;
+            histogram[gone]--;
+            if (gone < value) below--;
+        }
+        while (below > rank) {
+            value--;
+            below -= histogram[value];
+        }
+        while (below + histogram[value] <= rank) {
+            below += histogram[value];
+            value++;
+        }
+        out[i] = static_cast<uint8_t>(value);
+    }
+}
+
+} // namespace
+
+ByteFilter ByteFilter::parse(const std::string& spec) {
+    std::string lower;
+    for (char ch : spec) lower += static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    size_t split = 0;
+    while (split < lower.size() && std::isalpha(static_cast<unsigned char>(lower[split]))) split++;
+    const std::string name = lower.substr(0, split);
+    const std::string digits = lower.substr(split);
+
+    ByteFilter filter;
+    bool known = false;
+    for (const KindName& k : KindNames) {
+        if (name == k.name) {
+            filter.kind = k.kind;
+            known = true;
+        }
+    }
+    bool numeric = !digits.empty() && digits.size() <= 3 &&
+                   std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; });
+    if (!known || !numeric) {
+        throw std::runtime_error("Invalid byte filter (expected min, max, median, open or close "
+                                 "followed by the window, e.g. median9): " + spec);
+    }
+    filter.window = std::stoi(digits);
+    if (filter.window < 3 || filter.window > 255 || filter.window % 2 == 0) {
+        throw std::runtime_error("Byte filter window must be odd, 3 to 255: " + spec);
+    }
+    return filter;
+}
+
+std::string ByteFilter::toString() const {
+    for (const KindName& k : KindNames) {
+        if (k.kind == kind) return k.name + std::to_string(window);
+    }
+    return "filter" + std::to_string(window);
+}
+
+ByteFilterProcessor::ByteFilterProcessor(size_t size, const ByteFilter& filter, size_t rowLength)
+    : filter(filter), rowLength(rowLength == 0 ? std::max<size_t>(size, 1) : rowLength), bytes(size) {
+    if (filter.window < 3 || filter.window > 255 || filter.window % 2 == 0) {
+        throw std::runtime_error("Byte filter window must be odd, 3 to 255: " + filter.toString());
+    }
+}
+
+void ByteFilterProcessor::initializeFromCiphertext(const ByteSpan& cipherData) {
+    size_t limit = std::min(cipherData.size(), bytes.size());
+    std::fill(bytes.begin(), bytes.end(), 0);
+    std::copy(cipherData.begin(), cipherData.begin() + limit, bytes.begin());
+}
+
+// Row j of bytes starts at j * rowLength, and at j * (rowLength + window - 1)
+// in padded
+void ByteFilterProcessor::pad() {
+    const size_t r = static_cast<size_t>(filter.window / 2);
+    const size_t stride = rowLength + 2 * r;
+    padded.resize((bytes.size() + rowLength - 1) / rowLength * stride);
+    for (size_t start = 0, out = 0; start < bytes.size(); start += rowLength, out += stride) {
+        const size_t n = std::min(rowLength, bytes.size() - start);
+        const uint8_t* row = bytes.data() + start;
+        std::copy(row, row + n, padded.begin() + out + r);
+        for (size_t j = 1; j <= r; j++) {
+            padded[out + r - j] = row[mirror(-static_cast<long long>(j), n)];
+            padded[out + r + n - 1 + j] = row[mirror(static_cast<long long>(n - 1 + j), n)];
+        }
+    }
+}
+
+// bytes[i] = pick over padded[i, i + window) within each row. Within each
+// block of `window` bytes the running extreme is kept from the left (prefix)
+// and from the right (suffix); every window spans at most two blocks, so it
+// is the pick of one suffix and one prefix value.
+template <typename Pick>
+void ByteFilterProcessor::extreme(Pick pick) {
+    pad();
+    const size_t k = static_cast<size_t>(filter.window);
+    const size_t stride = rowLength + k - 1;
+    prefix.resize(padded.size());
+    suffix.resize(padded.size());
+    for (size_t row = 0, base = 0; row < bytes.size(); row += rowLength, base += stride) {
+        const size_t n = std::min(rowLength, bytes.size() - row);
+        const size_t m = base + n + k - 1;
+        for (size_t start = base; start < m; start += k) {
+            const size_t end = std::min(start + k, m);
+            // Running extremes in a local: through the uint8_t arrays every
+            // store could alias the next load
+            uint8_t run = padded[start];
+            for (size_t j = start; j < end; j++) {
+                run = pick(run, padded[j]);
+                prefix[j] = run;
+            }
+            run = padded[end - 1];
+            for (size_t j = end; j-- > start;) {
+                run = pick(run, padded[j]);
+                suffix[j] = run;
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            bytes[row + i] = pick(suffix[base + i], prefix[base + i + k - 1]);
+        }
+    }
+}
+
+void ByteFilterProcessor::median() {
+    pad();
+    const size_t k = static_cast<size_t>(filter.window);
+    const size_t stride = rowLength + k - 1;
+    const bool sse2 = simdLevel() >= SimdLevel::SSE2;
+    for (size_t row = 0, base = 0; row < bytes.size(); row += rowLength, base += stride) {
+        const size_t n = std::min(rowLength, bytes.size() - row);
+        size_t i = 0;
+        if (sse2) {
+            i = simd_kernels::runningMedianSse2(padded.data() + base, bytes.data() + row, 0, n, k);
+        }
+        runningMedian(padded.data() + base, bytes.data() + row, i, n, k);
+    }
+}
+
+void ByteFilterProcessor::update() {
+    if (bytes.empty()) return;
+    switch (filter.kind) {
+        case ByteFilter::Kind::Min: extreme(PickMin()); break;
+        case ByteFilter::Kind::Max: extreme(PickMax()); break;
+        case ByteFilter::Kind::Median: median(); break;
+        case ByteFilter::Kind::Open: extreme(PickMin()); extreme(PickMax()); break;
+        case ByteFilter::Kind::Close: extreme(PickMax()); extreme(PickMin()); break;
+    }
+}
+
+void ByteFilterProcessor::update(int generations) {
+    for (int g = 0; g < generations; g++) update();
+}
@@ -0,0 +1,63 @@
+#ifndef BYTE_FILTER_HPP
+#define BYTE_FILTER_HPP
+
+#include <vector>
+#include <cstdint>
+#include <string>
+#include "byte_span.hpp"
+
+// Morphological filter over a sliding window of bytes: grey-level erosion
+// (min), dilation (max), median, opening (min then max) or closing (max then
+// min). Windows are odd, 3 to 255 bytes, centred on each byte.
+struct ByteFilter {
+    enum class Kind { Min, Max, Median, Open, Close };
+
+    Kind kind = Kind::Median;
+    int window = 3;
+
+    // "median9", "min31", "open5", ...; throws std::runtime_error on bad input
+    static ByteFilter parse(const std::string& spec);
+    std::string toString() const;
+};
+
+// A ByteFilter applied as a 1D byte-valued CA, one filter pass per
+// generation, with bytes beyond either end mirrored (byte -1 reads as byte
+// 0). With a row length the bytes are rows of an image (the last may be
+// shorter), each filtered as a line of its own. Cost per byte does not depend on the window: min and max use the van
+// Herk/Gil-Werman block prefix and suffix extremes (three comparisons per
+// byte), the median a histogram slid along with the window (a two-level one
+// in SSE2 registers when available).
+class ByteFilterProcessor {
+public:
+    // rowLength 0 makes all `size` bytes one row
+    ByteFilterProcessor(size_t size, const ByteFilter& filter, size_t rowLength = 0);
+
+    // Initialize the bytes from ciphertext (a vector or a mapped file)
+    void initializeFromCiphertext(const ByteSpan& cipherData);
+
+    // Run one or `generations` filter passes
+    void update();
+    void update(int generations);
+
+    const ByteFilter& getFilter() const { return filter; }
+
+    // The filtered bytes, as a view valid until the next update or
+    // initialization, or as a copy
+    ByteSpan processedBytes() const { return ByteSpan(bytes.data(), bytes.size()); }
+    std::vector<uint8_t> extractProcessedData() const { return bytes; }
+
+private:
+    ByteFilter filter;
+    size_t rowLength;
+    std::vector<uint8_t> bytes;
+    std::vector<uint8_t> padded;    // rows with window / 2 mirrored on each side
+    std::vector<uint8_t> prefix;    // van Herk block extremes
+    std::vector<uint8_t> suffix;
+
+    void pad();
+    template <typename Pick>
+    void extreme(Pick pick);
+    void median();
+};
+
+#endif // BYTE_FILTER_HPP
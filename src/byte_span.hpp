@@ -0,0 +1,33 @@
+// byte_span.hpp
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Read-only, non-owning view of a contiguous byte buffer. Converts implicitly
+// from std::vector<uint8_t> and mirrors its read interface, so functions
+// taking a ByteSpan accept both in-memory buffers and memory-mapped files
+// without copying.
+class ByteSpan {
+public:
+    ByteSpan() = default;
+    ByteSpan(const uint8_t* data, size_t size) : ptr(data), count(size) {}
+    ByteSpan(const std::vector<uint8_t>& v) : ptr(v.data()), count(v.size()) {}
+
+    const uint8_t* data() const { return ptr; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    uint8_t operator[](size_t i) const { return ptr[i]; }
+    const uint8_t* begin() const { return ptr; }
+    const uint8_t* end() const { return ptr + count; }
+
+    ByteSpan subspan(size_t offset, size_t length) const {
+        if (offset > count) offset = count;
+        if (length > count - offset) length = count - offset;
+        return ByteSpan(ptr + offset, length);
+    }
+
+private:
+    const uint8_t* ptr = nullptr;
+    size_t count = 0;
+};
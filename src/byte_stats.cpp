@@ -0,0 +1,108 @@
+// byte_stats.cpp
+#include "byte_stats.hpp"
+#include "bit_utils.hpp"
+#include <algorithm>
+#include <cmath>
+
+void ByteStats::add(const ByteSpan& data) {
+    if (data.empty()) return;
+
+    ByteStats block;
+    uint64_t s = 0, sq = 0, lag = 0;
+    uint8_t prev = data[0];
+    for (size_t i = 0; i < data.size(); i++) {
+        uint8_t b = data[i];
+        block.histogram[b]++;
+        s += b;
+        sq += static_cast<uint64_t>(b) * b;
+        lag += static_cast<uint64_t>(prev) * b;
+        prev = b;
+    }
+    block.count = data.size();
+    block.sum = s;
+    block.sumSquares = sq;
+    block.lagProducts = lag - static_cast<uint64_t>(data[0]) * data[0];  // no predecessor for data[0]
+    block.first = data[0];
+    block.last = data[data.size() - 1];
+    merge(block);
+}
+
+void ByteStats::add(const ByteView& data) {
+    if (data.isContiguous()) {
+        add(data.contiguousSpan());
+        return;
+    }
+    // Gather through a small buffer; merge() keeps the pieces exact
+    uint8_t buffer[4096];
+    for (size_t pos = 0; pos < data.size(); pos += sizeof(buffer)) {
+        size_t n = std::min(sizeof(buffer), data.size() - pos);
+        for (size_t i = 0; i < n; i++) {
+            buffer[i] = data[pos + i];
+        }
+        add(ByteSpan(buffer, n));
+    }
+}
+
+void ByteStats::merge(const ByteStats& next) {
+    if (next.count == 0) return;
+    if (count == 0) {
+        *this = next;
+        return;
+    }
+    for (size_t i = 0; i < 256; i++) {
+        histogram[i] += next.histogram[i];
+    }
+    lagProducts += next.lagProducts + static_cast<uint64_t>(last) * next.first;
+    count += next.count;
+    sum += next.sum;
+    sumSquares += next.sumSquares;
+    last = next.last;
+}
+
+uint64_t ByteStats::onesCount() const {
+    uint64_t ones = 0;
+    for (size_t i = 0; i < 256; i++) {
+        ones += histogram[i] * popcount64(i);
+    }
+    return ones;
+}
+
+double ByteStats::indexOfCoincidence() const {
+    if (count < 2) return 0.0;
+    double total = 0.0;
+    for (auto freq : histogram) {
+        total += static_cast<double>(freq) * (static_cast<double>(freq) - 1.0);
+    }
+    return total / (static_cast<double>(count) * (static_cast<double>(count) - 1.0));
+}
+
+double ByteStats::chiSquare() const {
+    if (count == 0) return 0.0;
+    double expected = static_cast<double>(count) / 256.0;
+    double chi = 0.0;
+    for (auto freq : histogram) {
+        double diff = static_cast<double>(freq) - expected;
+        chi += (diff * diff) / expected;
+    }
+    return chi;
+}
+
+double ByteStats::serialCorrelation() const {
+    if (count < 2) return 0.0;
+
+    // Expand sum((x[i-1] - mean) * (x[i] - mean)) over i = 1..n-1 in terms of
+    // the running sums; "head" excludes the last byte, "tail" the first.
+    double n1 = static_cast<double>(count - 1);
+    double mean = static_cast<double>(sum) / static_cast<double>(count);
+    double sumHead = static_cast<double>(sum - last);
+    double sumTail = static_cast<double>(sum - first);
+    double sqHead = static_cast<double>(sumSquares - static_cast<uint64_t>(last) * last);
+    double sqTail = static_cast<double>(sumSquares - static_cast<uint64_t>(first) * first);
+
+    double num = static_cast<double>(lagProducts) - mean * (sumHead + sumTail) + n1 * mean * mean;
+    double den1 = sqHead - 2.0 * mean * sumHead + n1 * mean * mean;
+    double den2 = sqTail - 2.0 * mean * sumTail + n1 * mean * mean;
+
+    if (den1 == 0.0 || den2 == 0.0) return 0.0;
+    return num / std::sqrt(den1 * den2);
+}
@@ -0,0 +1,33 @@
+// byte_stats.hpp
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include "byte_span.hpp"
+#include "byte_view.hpp"
+
+// Mergeable byte statistics. Holds everything StatAnalyzer's index of
+// coincidence, chi-square and serial correlation need, so a buffer can be fed
+// in chunks (or in parallel pieces merged in order) and still give the same
+// results as one pass over the whole buffer.
+struct ByteStats {
+    std::array<uint64_t, 256> histogram{};
+    uint64_t count = 0;
+    uint64_t sum = 0;          // sum of bytes
+    uint64_t sumSquares = 0;   // sum of squared bytes
+    uint64_t lagProducts = 0;  // sum of data[i-1] * data[i]
+    uint8_t first = 0;
+    uint8_t last = 0;
+
+    void add(const ByteSpan& data);
+    void add(const ByteView& data);  // transformed views are read in place
+
+    // Append statistics of the bytes that immediately follow this block
+    void merge(const ByteStats& next);
+
+    uint64_t onesCount() const;  // total set bits
+
+    double indexOfCoincidence() const;
+    double chiSquare() const;
+    double serialCorrelation() const;
+};
@@ -0,0 +1,91 @@
+// byte_view.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include "byte_span.hpp"
+#include "bit_utils.hpp"
+
+// Lazily transformed, read-only view of a byte buffer. Reversal, decimation
+// (every k-th byte), complement and per-byte bit reversal compose without
+// copying: byte i of the view is source[start + step * i], optionally
+// bit-reversed and then inverted. Converts implicitly from ByteSpan.
+class ByteView {
+public:
+    ByteView() = default;
+    ByteView(const ByteSpan& bytes) : source(bytes), count(bytes.size()) {}
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    uint8_t operator[](size_t i) const {
+        uint8_t b = source[static_cast<size_t>(static_cast<ptrdiff_t>(start) + step * static_cast<ptrdiff_t>(i))];
+        if (bitReversed) b = reverseBits8(b);
+        return complemented ? static_cast<uint8_t>(~b) : b;
+    }
+
+    // Transforms
+    ByteView reverse() const {
+        ByteView v = *this;
+        if (count > 0) {
+            v.start = static_cast<size_t>(static_cast<ptrdiff_t>(start) + step * static_cast<ptrdiff_t>(count - 1));
+        }
+        v.step = -step;
+        return v;
+    }
+
+    ByteView complement() const {
+        ByteView v = *this;
+        v.complemented = !complemented;
+        return v;
+    }
+
+    // LSB-first reading of every byte
+    ByteView reverseBitOrder() const {
+        ByteView v = *this;
+        v.bitReversed = !bitReversed;
+        return v;
+    }
+
+    // Every k-th byte, starting at `phase`
+    ByteView decimate(size_t k, size_t phase = 0) const {
+        if (k == 0) throw std::runtime_error("Decimation factor must be positive");
+        ByteView v = *this;
+        if (phase >= count) {
+            v.count = 0;
+            return v;
+        }
+        v.start = static_cast<size_t>(static_cast<ptrdiff_t>(start) + step * static_cast<ptrdiff_t>(phase));
+        v.step = step * static_cast<ptrdiff_t>(k);
+        v.count = (count - phase + k - 1) / k;
+        return v;
+    }
+
+    ByteView subview(size_t offset, size_t length) const {
+        ByteView v = *this;
+        if (offset > count) offset = count;
+        if (length > count - offset) length = count - offset;
+        v.start = static_cast<size_t>(static_cast<ptrdiff_t>(start) + step * static_cast<ptrdiff_t>(offset));
+        v.count = length;
+        return v;
+    }
+
+    // A plain forward run of the source can be used as a ByteSpan directly
+    bool isContiguous() const { return (step == 1 || count <= 1) && !bitReversed && !complemented; }
+    ByteSpan contiguousSpan() const { return ByteSpan(source.data() + start, count); }
+
+    // Mapping details, for consumers that address the source themselves
+    const ByteSpan& sourceBytes() const { return source; }
+    size_t firstIndex() const { return start; }
+    ptrdiff_t stride() const { return step; }
+    bool isBitReversed() const { return bitReversed; }
+    bool isComplemented() const { return complemented; }
+
+private:
+    ByteSpan source;
+    size_t start = 0;
+    ptrdiff_t step = 1;
+    size_t count = 0;
+    bool bitReversed = false;
+    bool complemented = false;
+};
@@ -0,0 +1,317 @@
+#include "ca2d_processor.hpp"
+#include "ca_kernels.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+using simd_kernels::ScalarOps;
+
+simd_kernels::MooreRuleWords ruleWords(const MooreRule& rule) {
+    simd_kernels::MooreRuleWords words;
+    for (int k = 0; k < 10; k++) {
+        words.born[k] = (k <= 8 && ((rule.birth >> k) & 1)) ? ~0ULL : 0;
+        words.kept[k] = (k >= 1 && ((rule.survive >> (k - 1)) & 1)) ? ~0ULL : 0;
+    }
+    return words;
+}
+
+uint64_t bitAt(const uint64_t* words, size_t x) {
+    return (words[x / 64] >> (63 - x % 64)) & 1;
+}
+
+// `count` (<= 64) bits of `data` from bit `pos`, top-aligned; bits past the
+// end read as 0
+uint64_t readBits(const ByteSpan& data, size_t pos, unsigned count) {
+    uint64_t v = 0;
+    for (unsigned done = 0; done < count;) {
+        size_t byte = (pos + done) / 8;
+        unsigned offset = static_cast<unsigned>((pos + done) % 8);
+        unsigned take = std::min(8 - offset, count - done);
+        uint64_t bits = byte < data.size() ? (data[byte] >> (8 - offset - take)) & ((1u << take) - 1) : 0;
+        v |= bits << (64 - done - take);
+        done += take;
+    }
+    return v;
+}
+
+void writeBits(std::vector<uint8_t>& out, size_t pos, uint64_t value, unsigned count) {
+    for (unsigned done = 0; done < count;) {
+        size_t byte = (pos + done) / 8;
+        unsigned offset = static_cast<unsigned>((pos + done) % 8);
+        unsigned take = std::min(8 - offset, count - done);
+        uint64_t bits = (value << done) >> (64 - take);
+        out[byte] |= static_cast<uint8_t>(bits << (8 - offset - take));
+        done += take;
+    }
+}
+
+} // namespace
+
+MooreRule MooreRule::parse(const std::string& spec) {
+    MooreRule rule;
+    bool seenB = false, seenS = false, valid = true;
+    uint16_t* target = nullptr;
+    for (char ch : spec) {
+        char c = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+        if (c == 'B' && !seenB) {
+            seenB = true;
+            target = &rule.birth;
+        } else if (c == 'S' && !seenS) {
+            seenS = true;
+            target = &rule.survive;
+        } else if (c >= '0' && c <= '8' && target) {
+            *target |= static_cast<uint16_t>(1u << (c - '0'));
+        } else if (c != '/') {
+            valid = false;
+        }
+    }
+    if (!valid || !seenB || !seenS) {
+        throw std::runtime_error("Invalid Moore rule (expected B<digits>/S<digits>): " + spec);
+    }
+    return rule;
+}
+
+std::string MooreRule::toString() const {
+    std::string s = "B";
+    for (int k = 0; k <= 8; k++) if ((birth >> k) & 1) s += static_cast<char>('0' + k);
+    s += "/S";
+    for (int k = 0; k <= 8; k++) if ((survive >> k) & 1) s += static_cast<char>('0' + k);
+    return s;
+}
+
+EdgeMode parseEdgeMode(const std::string& name) {
+    if (name == "null" || name == "zero") return EdgeMode::Null;
+    if (name == "periodic" || name == "wrap") return EdgeMode::Periodic;
+    if (name == "mirror" || name == "mirrored") return EdgeMode::Mirrored;
+    throw std::runtime_error("Unknown edge mode: " + name + " (expected null, periodic or mirror)");
+}
+
+CA2DProcessor::CA2DProcessor(size_t width, size_t cellCount, const MooreRule& rule, EdgeMode edges)
+    : width(width), height(width ? (cellCount + width - 1) / width : 0), cellCount(cellCount),
+      rowWords((width + 63) / 64), rule(rule), edges(edges) {
+    if (width == 0) {
+        throw std::runtime_error("2D CA width must be positive");
+    }
+    grid.assign(height * rowWords, 0);
+    nextGrid.assign(grid.size(), 0);
+    zeroRow.assign(rowWords, 0);
+    plane0.assign(rowWords + 2, 0);
+    plane1.assign(rowWords + 2, 0);
+}
+
+size_t CA2DProcessor::detectWidth(const ByteSpan& data) {
+    // Compare bytes one stride apart over a sample; row-structured data
+    // (raw images, ECB blocks of a table) repeats at its row stride
+    const size_t sample = std::min<size_t>(data.size(), 64 * 1024);
+    const size_t maxStride = std::min<size_t>(2048, sample / 4);
+    size_t bestStride = 0;
+    double best = 0.0, total = 0.0;
+    size_t candidates = 0;
+    for (size_t k = 8; k <= maxStride; k++) {
+        size_t matches = 0;
+        for (size_t i = 0; i + k < sample; i++) {
+            matches += data[i] == data[i + k];
+        }
+        double rate = static_cast<double>(matches) / static_cast<double>(sample - k);
+        total += rate;
+        candidates++;
+        if (rate > best) {
+            best = rate;
+            bestStride = k;
+        }
+    }
+
+    // Accept a stride that is well above both chance and the typical stride
+    if (candidates > 0 && best > 4.0 / 256 && best > 1.5 * total / candidates) {
+        return bestStride * 8;
+    }
+    double side = std::sqrt(static_cast<double>(data.size()) * 8);
+    return std::max<size_t>(64, (static_cast<size_t>(std::ceil(side)) + 63) / 64 * 64);
+}
+
+void CA2DProcessor::initializeFromCiphertext(const ByteSpan& cipherData) {
+    const size_t available = std::min(cellCount, cipherData.size() * 8);
+    for (size_t y = 0; y < height; y++) {
+        for (size_t w = 0; w < rowWords; w++) {
+            size_t pos = y * width + w * 64;
+            size_t bits = std::min<size_t>(64, width - w * 64);
+            uint64_t v = pos < available ? readBits(cipherData, pos, static_cast<unsigned>(bits)) : 0;
+            grid[y * rowWords + w] = v & wordMask(y, w);
+        }
+    }
+}
+
+// Cells that exist in word w of row y: the row's width, and in the last
+// row the end of the data
+uint64_t CA2DProcessor::wordMask(size_t y, size_t w) const {
+    size_t rowCells = std::min(width, cellCount - y * width);
+    if (w * 64 >= rowCells) return 0;
+    size_t live = rowCells - w * 64;
+    return live >= 64 ? ~0ULL : ~0ULL << (64 - live);
+}
+
+const uint64_t* CA2DProcessor::rowPointer(long long y) const {
+    long long h = static_cast<long long>(height);
+    if (y < 0 || y >= h) {
+        switch (edges) {
+            case EdgeMode::Null: return zeroRow.data();
+            case EdgeMode::Periodic: y = (y + h) % h; break;
+            case EdgeMode::Mirrored: y = y < 0 ? 0 : h - 1; break;
+        }
+    }
+    return grid.data() + static_cast<size_t>(y) * rowWords;
+}
+
+void CA2DProcessor::stepRow(const uint64_t* up, const uint64_t* centre, const uint64_t* down,
+                            uint64_t* out, size_t y) {
+    using namespace simd_kernels;
+    const MooreRuleWords ruleMasks = ruleWords(rule);
+    const SimdLevel level = simdLevel();
+    uint64_t* a0 = plane0.data();
+    uint64_t* a1 = plane1.data();
+
+    // Column sums, word w stored at index w + 1
+    size_t w = 0;
+    switch (level) {
+        case SimdLevel::AVX512: w = mooreColumnsAvx512(up, centre, down, a0 + 1, a1 + 1, w, rowWords); break;
+        case SimdLevel::AVX2: w = mooreColumnsAvx2(up, centre, down, a0 + 1, a1 + 1, w, rowWords); break;
+        case SimdLevel::SSE2: w = mooreColumnsSse2(up, centre, down, a0 + 1, a1 + 1, w, rowWords); break;
+        case SimdLevel::Scalar: break;
+    }
+    sumColumns<ScalarOps>(up, centre, down, a0 + 1, a1 + 1, w, rowWords);
+
+    // Edge columns: cell -1 is the low bit of the front word, cell
+    // `width` the bit just past the row (padding bits are 0)
+    a0[0] = a1[0] = 0;
+    a0[rowWords + 1] = a1[rowWords + 1] = 0;
+    if (edges != EdgeMode::Null) {
+        size_t westSource = edges == EdgeMode::Periodic ? width - 1 : 0;
+        size_t eastSource = edges == EdgeMode::Periodic ? 0 : width - 1;
+        uint64_t west0 = bitAt(a0 + 1, westSource), west1 = bitAt(a1 + 1, westSource);
+        uint64_t east0 = bitAt(a0 + 1, eastSource), east1 = bitAt(a1 + 1, eastSource);
+        a0[0] = west0;
+        a1[0] = west1;
+        a0[1 + width / 64] |= east0 << (63 - width % 64);
+        a1[1 + width / 64] |= east1 << (63 - width % 64);
+    }
+
+    w = 0;
+    switch (level) {
+        case SimdLevel::AVX512: w = mooreRuleAvx512(a0, a1, centre, out, w, rowWords, ruleMasks); break;
+        case SimdLevel::AVX2: w = mooreRuleAvx2(a0, a1, centre, out, w, rowWords, ruleMasks); break;
+        case SimdLevel::SSE2: w = mooreRuleSse2(a0, a1, centre, out, w, rowWords, ruleMasks); break;
+        case SimdLevel::Scalar: break;
+    }
+    applyRule<ScalarOps>(a0, a1, centre, out, w, rowWords, ruleMasks);
+
+    // Padding cells stay dead
+    out[rowWords - 1] &= wordMask(y, rowWords - 1);
+    if (y == height - 1) {
+        for (size_t k = 0; k < rowWords; k++) out[k] &= wordMask(y, k);
+    }
+}
+
+void CA2DProcessor::update() {
+    if (cellCount == 0) return;
+    for (size_t y = 0; y < height; y++) {
+        stepRow(rowPointer(static_cast<long long>(y) - 1), rowPointer(static_cast<long long>(y)),
+                rowPointer(static_cast<long long>(y) + 1), nextGrid.data() + y * rowWords, y);
+    }
+    grid.swap(nextGrid);
+}
+
+// Grid row that virtual row v (any integer) holds under the edge mode, or -1
+// for the permanently dead rows outside a null edge. Mirrored and periodic
+// grids extend to infinite configurations (reflected with period 2h, or
+// repeated with period h) that evolve consistently, so copies of edge rows
+// can be advanced like any other row.
+long long CA2DProcessor::sourceRow(long long v) const {
+    const long long h = static_cast<long long>(height);
+    if (v >= 0 && v < h) return v;
+    switch (edges) {
+        case EdgeMode::Null:
+            return -1;
+        case EdgeMode::Periodic:
+            return ((v % h) + h) % h;
+        case EdgeMode::Mirrored: {
+            long long m = ((v % (2 * h)) + 2 * h) % (2 * h);
+            return m < h ? m : 2 * h - 1 - m;
+        }
+    }
+    return -1;
+}
+
+void CA2DProcessor::update(int generations) {
+    if (cellCount == 0 || generations <= 0) return;
+    const size_t rowBytes = rowWords * 8;
+    if (grid.size() * 8 <= 2 * TileBytes) {
+        for (int g = 0; g < generations; g++) update();
+        return;
+    }
+
+    // Bands of rows are copied out with `depth` rows above and below and
+    // advanced `depth` generations in two band-sized buffers. Each generation
+    // leaves one more row at either end stale, so only the shrinking
+    // trapezoid that still feeds the band is computed; rows beyond a null
+    // edge stay zero and are never advanced.
+    CellWords band, bandNext;
+    std::vector<long long> source;
+    int done = 0;
+    while (done < generations) {
+        const size_t depth = static_cast<size_t>(std::min(generations - done, MaxBlockDepth));
+        const size_t bandRows = std::max(TileBytes / rowBytes, 4 * depth);
+        band.resize((bandRows + 2 * depth) * rowWords);
+        bandNext.resize(band.size());
+
+        for (size_t y0 = 0; y0 < height; y0 += bandRows) {
+            const size_t y1 = std::min(y0 + bandRows, height);
+            const size_t n = (y1 - y0) + 2 * depth;
+            source.resize(n);
+            for (size_t j = 0; j < n; j++) {
+                source[j] = sourceRow(static_cast<long long>(y0 + j) - static_cast<long long>(depth));
+                uint64_t* row = band.data() + j * rowWords;
+                if (source[j] >= 0) {
+                    std::copy_n(grid.data() + static_cast<size_t>(source[j]) * rowWords, rowWords, row);
+                } else {
+                    std::fill_n(row, rowWords, 0);
+                    std::fill_n(bandNext.data() + j * rowWords, rowWords, 0);
+                }
+            }
+
+            for (size_t g = 0; g < depth; g++) {
+                for (size_t j = g + 1; j + g + 1 < n; j++) {
+                    if (source[j] < 0) continue;
+                    stepRow(band.data() + (j - 1) * rowWords, band.data() + j * rowWords,
+                            band.data() + (j + 1) * rowWords, bandNext.data() + j * rowWords,
+                            static_cast<size_t>(source[j]));
+                }
+                band.swap(bandNext);
+            }
+            std::copy_n(band.begin() + depth * rowWords, (y1 - y0) * rowWords,
+                        nextGrid.begin() + y0 * rowWords);
+        }
+        grid.swap(nextGrid);
+        done += static_cast<int>(depth);
+    }
+}
+
+bool CA2DProcessor::cell(size_t x, size_t y) const {
+    if (x >= width || y >= height) return false;
+    return bitAt(grid.data() + y * rowWords, x) != 0;
+}
+
+std::vector<uint8_t> CA2DProcessor::extractProcessedData() const {
+    std::vector<uint8_t> out((cellCount + 7) / 8, 0);
+    for (size_t y = 0; y < height; y++) {
+        for (size_t w = 0; w < rowWords; w++) {
+            size_t pos = y * width + w * 64;
+            if (pos >= cellCount) break;
+            size_t bits = std::min<size_t>({64, width - w * 64, cellCount - pos});
+            writeBits(out, pos, grid[y * rowWords + w], static_cast<unsigned>(bits));
+        }
+    }
+    return out;
+}
@@ -0,0 +1,96 @@
+#ifndef CA2D_PROCESSOR_HPP
+#define CA2D_PROCESSOR_HPP
+
+#include <vector>
+#include <cstdint>
+#include <string>
+#include "aligned_allocator.hpp"
+#include "byte_span.hpp"
+
+// Outer-totalistic rule on the Moore neighbourhood, in B/S notation: a dead
+// cell with a neighbour count in `birth` comes alive, a live cell with a
+// count in `survive` stays alive (bit k of each mask is count k, 0-8)
+struct MooreRule {
+    uint16_t birth = 0;
+    uint16_t survive = 0;
+
+    // "B3/S23" style, either order, case-insensitive; throws on bad input
+    static MooreRule parse(const std::string& spec);
+    std::string toString() const;
+};
+
+// How cells outside the grid read
+enum class EdgeMode {
+    Null,      // dead
+    Periodic,  // wrap around (torus)
+    Mirrored   // reflected about the border: cell -1 reads as cell 0
+};
+
+EdgeMode parseEdgeMode(const std::string& name);  // "null", "periodic", "mirror"
+
+// Two-dimensional Moore-neighbourhood CA over the bits of the ciphertext.
+//
+// The bits are laid out row by row, `width` cells per row, in stream order;
+// a final partial row is padded with cells that stay dead. Rows are packed
+// 64 cells to a word (first cell in the top bit), and each generation sums
+// the three rows of every column with bit-parallel full adders, then the
+// three columns of every cell the same way, giving the 3x3 count as four
+// bit planes that select the next state word by word (SSE2, AVX2 or AVX-512
+// kernels, chosen at run time).
+class CA2DProcessor {
+public:
+    CA2DProcessor(size_t width, size_t cellCount, const MooreRule& rule,
+                  EdgeMode edges = EdgeMode::Mirrored);
+
+    // Row width suggested for `data`: the byte stride with the strongest
+    // repetition if one stands out (image-like data), otherwise a near
+    // square grid
+    static size_t detectWidth(const ByteSpan& data);
+
+    // Initialize the grid from ciphertext (a vector or a mapped file)
+    void initializeFromCiphertext(const ByteSpan& cipherData);
+
+    // Cache tiling for update(int): bytes of rows per band and
+    // generations fused per pass over the grid
+    static constexpr size_t TileBytes = 256 * 1024;
+    static constexpr int MaxBlockDepth = 8;
+
+    // Advance every cell by one generation
+    void update();
+
+    // Advance every cell by `generations` generations. Large grids are
+    // processed in bands of rows, each band running several generations
+    // while it is in cache. Same result as calling update() in a loop.
+    void update(int generations);
+
+    bool cell(size_t x, size_t y) const;
+    size_t getWidth() const { return width; }
+    size_t getHeight() const { return height; }
+
+    // The first cellCount cells, packed back into bytes in stream order
+    std::vector<uint8_t> extractProcessedData() const;
+
+private:
+    const uint64_t* rowPointer(long long y) const;
+    long long sourceRow(long long v) const;
+    uint64_t wordMask(size_t y, size_t w) const;
+
+    // Next state of grid row y, from its rows above and below
+    void stepRow(const uint64_t* up, const uint64_t* centre, const uint64_t* down,
+                 uint64_t* out, size_t y);
+
+    size_t width;
+    size_t height;
+    size_t cellCount;
+    size_t rowWords;
+    MooreRule rule;
+    EdgeMode edges;
+
+    CellWords grid;                  // height rows of rowWords words
+    CellWords nextGrid;
+    std::vector<uint64_t> zeroRow;
+    std::vector<uint64_t> plane0;    // per-column vertical sums of a row,
+    std::vector<uint64_t> plane1;    // with one edge word on either side
+};
+
+#endif // CA2D_PROCESSOR_HPP
@@ -1,48 +1,784 @@
 #include "ca_analyzer.hpp"
-#include <immintrin.h>
+#include "bit_utils.hpp"
+#include "ca_kernels.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <string>
 
-CellularAutomataProcessor::CellularAutomataProcessor(size_t size, int rule) 
-    : dataSize(size), ruleNumber(rule), grid(size), nextGrid(size) {}
+namespace {
 
-void CellularAutomataProcessor::initializeFromCiphertext(const std::vector<uint8_t>& cipherData) {
+// One generation of in[first, last) into out under `rule`, with the widest
+// kernel available; in[first - 1] and in[last] are read as neighbours
+void stepRange(uint8_t rule, const uint64_t* in, uint64_t* out, size_t first, size_t last) {
+    using namespace simd_kernels;
+    static constexpr auto scalarKernels = elementaryKernels<ScalarOps>(std::make_index_sequence<256>{});
+    size_t w = first;
+    switch (simdLevel()) {
+        case SimdLevel::AVX512: w = elementaryAvx512(in, out, w, last, rule); break;
+        case SimdLevel::AVX2: w = elementaryAvx2(in, out, w, last, rule); break;
+        case SimdLevel::SSE2: w = elementarySse2(in, out, w, last, rule); break;
+        case SimdLevel::Scalar: break;
+    }
+    scalarKernels[rule](in, out, w, last);
+}
+
+// Mask of the live cells in the last word of a `bytes`-byte grid
+uint64_t tailMaskFor(size_t bytes) {
+    unsigned used = static_cast<unsigned>((bytes * 8) % 64);
+    return used == 0 ? ~0ULL : ~0ULL << (64 - used);
+}
+
+// Tile t of a pass over `words` words: its own words [start, end) and the
+// words [lo, hi) it is computed from, as indices into the guarded array
+struct Tile {
+    size_t start, end, lo, hi;
+};
+
+Tile tileAt(size_t t, size_t tileWords, size_t words, size_t halo) {
+    Tile tile;
+    tile.start = 1 + t * tileWords;
+    tile.end = std::min(tile.start + tileWords, words + 1);
+    tile.lo = tile.start > halo ? tile.start - halo : 1;
+    tile.hi = std::min(tile.end + halo, words + 1);
+    return tile;
+}
+
+// buffer = [0 | cells[lo, hi) | 0]
+void loadTile(const uint64_t* cells, const Tile& tile, CellWords& buffer) {
+    buffer.assign(tile.hi - tile.lo + 2, 0);
+    std::copy(cells + tile.lo, cells + tile.hi, buffer.begin() + 1);
+}
+
+// What a tile pass records about the tile's own words after each generation
+// g of the pass: its part of the fingerprint (slot g) and of the statistics
+// (slot g - statsFrom, for g >= statsFrom), each optional. Both are exact at
+// every generation, as the halo covers the whole depth; the statistics also
+// pair the tile's first byte with the byte before it, for which passHalo
+// adds a byte of halo.
+struct TileRecord {
+    GridFingerprint* fingerprints = nullptr;
+    GenerationStats* stats = nullptr;
+    int statsFrom = 0;
+    size_t statsBytes = 0;  // the tile's data bytes
+    bool atEnd = false;     // the tile holds the grid's last byte
+};
+
+// Statistics slots of `tile` in a pass over a `size`-byte grid of `words` words
+TileRecord statsRecord(const Tile& tile, size_t words, size_t size, GenerationStats* stats, int statsFrom) {
+    TileRecord record;
+    record.stats = stats;
+    record.statsFrom = statsFrom;
+    record.atEnd = tile.end == words + 1;
+    record.statsBytes = record.atEnd ? size - 8 * (tile.start - 1) : 8 * (tile.end - tile.start);
+    return record;
+}
+
+// Advances a loaded tile `depth` generations, recording what `record` asks
+// for. `lastMask` clears the padding cells when the tile ends at the end of
+// the grid (~0 otherwise).
+void advanceTile(uint8_t rule, CellWords& buffer, CellWords& spare, const Tile& tile,
+                 int depth, uint64_t lastMask, const TileRecord& record = TileRecord()) {
+    const size_t n = buffer.size() - 2;
+    spare.assign(buffer.size(), 0);
+    for (int g = 0; g < depth; g++) {
+        stepRange(rule, buffer.data(), spare.data(), 1, n + 1);
+        spare[n] &= lastMask;
+        buffer.swap(spare);
+        // Buffer word b is data word tile.lo + b - 2
+        if (record.fingerprints) {
+            record.fingerprints[g].merge(fingerprintRange(buffer.data(), 1 + tile.start - tile.lo,
+                                                          1 + tile.end - tile.lo, tile.lo - 2));
+        }
+        if (record.stats && g >= record.statsFrom) {
+            gatherStats(buffer.data() + 1 + (tile.start - tile.lo), record.statsBytes, tile.start > 1,
+                        record.atEnd, false, record.stats[g - record.statsFrom]);
+        }
+    }
+}
+
+void storeTile(const CellWords& buffer, const Tile& tile, uint64_t* cells) {
+    std::copy(buffer.begin() + 1 + (tile.start - tile.lo), buffer.begin() + 1 + (tile.end - tile.lo),
+              cells + tile.start);
+}
+
+// Toggles the data words of a guarded grid between cell order and
+// stream-order bytes
+void swapGridBytes(CellWords& grid) {
+    for (size_t w = 1; w + 1 < grid.size(); w++) {
+        grid[w] = byteSwap64(grid[w]);
+    }
+}
+
+// Copy of the first `size` bytes of a guarded grid's data
+std::vector<uint8_t> copyGridBytes(const CellWords& grid, size_t size, bool streamOrder) {
+    const size_t words = grid.size() - 2;
+    std::vector<uint8_t> out(words * 8);
+    if (streamOrder && words > 0) {
+        std::memcpy(out.data(), grid.data() + 1, out.size());
+    } else {
+        for (size_t w = 0; w < words; w++) {
+            storeBigEndian64(out.data() + 8 * w, grid[w + 1]);
+        }
+    }
+    out.resize(size);
+    return out;
+}
+
+ByteSpan gridBytes(const CellWords& grid, size_t size) {
+    return ByteSpan(reinterpret_cast<const uint8_t*>(grid.data() + 1), size);
+}
+
+void requireGrid(const CellWords& grid) {
+    if (grid.empty()) {
+        throw std::runtime_error("CA grid was released; initialize the processor again");
+    }
+}
+
+struct TileBuffers {
+    CellWords input;  // shared input tile (MultiRuleCAProcessor)
+    CellWords tile;
+    CellWords spare;
+    std::vector<GridFingerprint> fingerprints;  // this worker's share, per generation
+    std::vector<GenerationStats> stats;         // this worker's parts, per recorded generation
+};
+
+// Fingerprint of a guarded grid's data (grid word w is data word w - 1)
+GridFingerprint fingerprintGrid(const CellWords& grid) {
+    return fingerprintRange(grid.data(), 1, grid.size() - 1, ~0ULL);
+}
+
+// Fingerprints of the generations of a pass: the workers' shares merged
+std::vector<GridFingerprint> mergeFingerprints(const std::vector<TileBuffers>& workers, size_t count) {
+    std::vector<GridFingerprint> merged(count);
+    for (const TileBuffers& worker : workers) {
+        for (size_t g = 0; g < worker.fingerprints.size(); g++) {
+            merged[g].merge(worker.fingerprints[g]);
+        }
+    }
+    return merged;
+}
+
+// Statistics of the generations of a pass: the workers' parts added up
+std::vector<GenerationStats> mergeStats(const std::vector<TileBuffers>& workers, size_t count) {
+    std::vector<GenerationStats> merged(count);
+    for (const TileBuffers& worker : workers) {
+        for (size_t g = 0; g < worker.stats.size(); g++) {
+            merged[g].addPart(worker.stats[g]);
+        }
+    }
+    for (GenerationStats& stats : merged) {
+        stats.finish();
+    }
+    return merged;
+}
+
+// Where stepGrid appends the statistics of the generations it computes:
+// every one, or only the last generation of the call (nothing without a log)
+struct StatsSink {
+    std::vector<GenerationStats>* log = nullptr;
+    bool every = false;
+
+    bool keepsEvery() const { return log && every; }
+};
+
+StatsSink statsSink(CAStats mode, std::vector<GenerationStats>& log) {
+    StatsSink sink;
+    if (mode != CAStats::None) {
+        sink.log = &log;
+        sink.every = mode == CAStats::Every;
+    }
+    return sink;
+}
+
+// Statistics of generation t from a processor's CAStats::Every log
+const GenerationStats& loggedStats(CAStats gathering, const std::vector<GenerationStats>& log,
+                                   const CycleDetector& cycle, uint64_t generations, uint64_t t) {
+    if (gathering != CAStats::Every) {
+        throw std::runtime_error("Per-generation CA statistics need CAStats::Every");
+    }
+    if (t > generations) {
+        throw std::runtime_error("CA generation " + std::to_string(t) + " not reached (at " +
+                                 std::to_string(generations) + ")");
+    }
+    // The log runs at least one verified period past the generation the
+    // cycle was confirmed from, so its last period stands for any later one
+    if (t >= log.size() && cycle.found()) {
+        const uint64_t from = log.size() - cycle.period();
+        t = from + (t - from) % cycle.period();
+    }
+    // An empty grid is never stepped and logs generation 0 only
+    return log[std::min<uint64_t>(t, log.size() - 1)];
+}
+
+// Linear rules 90 (l ^ r) and 150 (l ^ c ^ r) are jumped ahead instead of
+// stepped. Over GF(2), t generations multiply the row by p(x)^t with
+// p = x^-1 + x or x^-1 + 1 + x, and p(x)^(2^k) = p(x^(2^k)), so t
+// generations are one "xor of the row shifted by +-2^k" pass per set bit k
+// of t. The zero boundary is handled by reflection: the row x (n bits)
+// becomes the ring [0 | x | 0 | reversed x] of 2n + 2 bits, which the rule
+// maps to a ring of the same shape, so its first half evolves exactly like
+// the bounded row.
+bool isJumpRule(uint8_t rule) {
+    return rule == 90 || rule == 150;
+}
+
+// 64 bits of a packed bit array from bit `pos`, top-aligned; `words` needs
+// a word past the last one read
+uint64_t bitsFrom(const uint64_t* words, size_t pos) {
+    size_t w = pos / 64;
+    unsigned o = static_cast<unsigned>(pos % 64);
+    return o == 0 ? words[w] : (words[w] << o) | (words[w + 1] >> (64 - o));
+}
+
+// 64 bits of a ring of `bits` bits (padding bits zero) from bit `pos`
+uint64_t ringBitsFrom(const uint64_t* words, size_t bits, size_t pos) {
+    uint64_t v = bitsFrom(words, pos);
+    if (pos + 64 > bits) v |= bitsFrom(words, 0) >> (bits - pos);
+    return v;
+}
+
+// Bits of word j of a packed bit array that lie in positions [lo, hi]
+uint64_t spanMask(size_t j, size_t lo, size_t hi) {
+    if (hi < 64 * j || lo > 64 * j + 63) return 0;
+    const unsigned from = lo > 64 * j ? static_cast<unsigned>(lo - 64 * j) : 0;
+    const unsigned to = hi < 64 * j + 63 ? static_cast<unsigned>(hi - 64 * j) : 63;
+    return (~0ULL >> from) & (~0ULL << (63 - to));
+}
+
+// Whether jumping `generations` ahead beats stepping (see JumpPassGenerations)
+bool jumpPays(uint8_t rule, int generations) {
+    const uint64_t t = static_cast<uint64_t>(generations);
+    return isJumpRule(rule) &&
+           t >= CellularAutomataProcessor::JumpPassGenerations * (popcount64(t) + 4);
+}
+
+// Advances guarded cells (n = `bits` cells in cells[1..]) by `generations`;
+// each pass is split into TileWords-word chunks over the pool's workers
+void jumpLinear(uint8_t rule, CellWords& cells, size_t bits, uint64_t generations,
+                WorkerPool& pool) {
+    constexpr size_t TileWords = CellularAutomataProcessor::TileWords;
+    const size_t words = cells.size() - 2;
+    const size_t ringBits = 2 * bits + 2;
+    const size_t ringWords = (ringBits + 63) / 64;
+    const size_t chunks = (ringWords + TileWords - 1) / TileWords;
+
+    // Ring bit q is x[q - 1] in the first half and x[2n + 1 - q] in the
+    // second, i.e. cells bit 63 + q and 2n + 65 - q of the guarded row; the
+    // reversed half is read 64 bits at a time and bit-reversed
+    CellWords ring(ringWords + 1, 0), next(ringWords + 1, 0);
+    runJobs(pool, chunks, [&](size_t c) {
+        const size_t end = std::min(ringWords, (c + 1) * TileWords);
+        for (size_t j = c * TileWords; j < end; j++) {
+            if (64 * j <= bits) {
+                ring[j] = bitsFrom(cells.data(), 64 * j + 63) & spanMask(j, 1, bits);
+            }
+            if (64 * j + 63 >= bits + 2) {
+                ring[j] |= reverseBits64(bitsFrom(cells.data(), 2 * bits + 2 - 64 * j)) &
+                           spanMask(j, bits + 2, 2 * bits + 1);
+            }
+        }
+    });
+
+    const uint64_t lastMask = ringBits % 64 ? ~0ULL << (64 - ringBits % 64) : ~0ULL;
+    size_t shift = 1 % ringBits;  // 2^k mod ring size
+    for (uint64_t t = generations; t != 0; t >>= 1) {
+        if (t & 1) {
+            const size_t back = ringBits - shift;
+            runJobs(pool, chunks, [&](size_t c) {
+                const size_t end = std::min(ringWords, (c + 1) * TileWords);
+                size_t left = (64 * c * TileWords + back) % ringBits;
+                size_t right = (64 * c * TileWords + shift) % ringBits;
+                for (size_t j = c * TileWords; j < end; j++) {
+                    uint64_t v = ringBitsFrom(ring.data(), ringBits, left) ^
+                                 ringBitsFrom(ring.data(), ringBits, right);
+                    next[j] = rule == 150 ? v ^ ring[j] : v;
+                    left = left + 64 < ringBits ? left + 64 : left + 64 - ringBits;
+                    right = right + 64 < ringBits ? right + 64 : right + 64 - ringBits;
+                }
+            });
+            next[ringWords - 1] &= lastMask;
+            ring.swap(next);
+        }
+        shift = (2 * shift) % ringBits;
+    }
+
+    for (size_t j = 0; j < words; j++) {
+        cells[j + 1] = bitsFrom(ring.data(), 64 * j + 1);
+    }
+    cells[words] &= tailMaskFor(bits / 8);
+}
+
+// Depth of the next tiled pass: up to MaxBlockDepth, and while `detector`
+// watches, no more than it has seen (see MinWatchDepth)
+int passDepth(int generations, const CycleDetector* detector) {
+    int depth = std::min(generations, CellularAutomataProcessor::MaxBlockDepth);
+    if (detector) {
+        const uint64_t seen = std::max<uint64_t>(detector->generation(), CellularAutomataProcessor::MinWatchDepth);
+        depth = static_cast<int>(std::min<uint64_t>(static_cast<uint64_t>(depth), seen));
+    }
+    return depth;
+}
+
+// Halo words of a tiled pass `depth` generations deep; gathering statistics
+// needs the byte before each tile exact as well (see TileRecord)
+size_t passHalo(int depth, bool gathering) {
+    return (static_cast<size_t>(depth) + (gathering ? 8 : 0) + 63) / 64;
+}
+
+// Steps a guarded grid of `size` bytes up to `generations` generations.
+// Small grids are stepped whole; larger ones tile by tile, each tile running
+// several generations while it is in cache, so the grid crosses the memory
+// bus once per pass instead of once per generation. With a detector, every
+// generation's fingerprint is reported to it and stepping stops at the end
+// of the pass that raises a candidate cycle. Statistics go to `stats`.
+// Returns the generations done.
+int stepGrid(uint8_t rule, CellWords& cells, CellWords& nextCells, size_t size, int generations,
+             WorkerPool& pool, CycleDetector* detector, StatsSink stats = StatsSink()) {
+    constexpr size_t TileWords = CellularAutomataProcessor::TileWords;
+    const size_t words = cells.size() - 2;
+    const uint64_t lastMask = tailMaskFor(size);
+    if (words <= TileWords) {
+        for (int g = 0; g < generations; g++) {
+            stepRange(rule, cells.data(), nextCells.data(), 1, words + 1);
+
+            // Cells past the end of the data stay 0 so they read as the boundary
+            nextCells[words] &= lastMask;
+            cells.swap(nextCells);
+            if (stats.log && (stats.every || g + 1 == generations)) {
+                stats.log->push_back(gridStats(cells, size, false));
+            }
+            if (detector && detector->observe(fingerprintGrid(cells))) return g + 1;
+        }
+        return generations;
+    }
+
+    // Each tile is copied out with `halo` words on either side and advanced
+    // `depth` generations in two cache-resident buffers. A cell's value after
+    // d generations depends on the d cells to each side, so the halo words
+    // absorb the error from the cut ends and the tile's own words come out
+    // exact; where the tile reaches the end of the grid the zero guard word
+    // is the real boundary. Tiles only read `cells` and write disjoint parts
+    // of `nextCells`, so the workers need no synchronization within a pass.
+    const size_t tileCount = (words + TileWords - 1) / TileWords;
+    int done = 0;
+    while (done < generations) {
+        const int depth = passDepth(generations - done, detector);
+        const int statsFrom = stats.every ? 0 : done + depth == generations ? depth - 1 : depth;
+        const bool gathering = stats.log && statsFrom < depth;
+        const size_t halo = passHalo(depth, gathering);
+        auto workers = runParallel<TileBuffers>(pool, tileCount, [&](size_t t, TileBuffers& buffers) {
+            const Tile tile = tileAt(t, TileWords, words, halo);
+            TileRecord record;
+            if (gathering) {
+                buffers.stats.resize(static_cast<size_t>(depth - statsFrom));
+                record = statsRecord(tile, words, size, buffers.stats.data(), statsFrom);
+            }
+            if (detector) {
+                buffers.fingerprints.resize(static_cast<size_t>(depth));
+                record.fingerprints = buffers.fingerprints.data();
+            }
+            loadTile(cells.data(), tile, buffers.tile);
+            advanceTile(rule, buffers.tile, buffers.spare, tile, depth,
+                        tile.hi == words + 1 ? lastMask : ~0ULL, record);
+            storeTile(buffers.tile, tile, nextCells.data());
+        });
+        cells.swap(nextCells);
+        done += depth;
+
+        if (gathering) {
+            for (GenerationStats& generation : mergeStats(workers, static_cast<size_t>(depth - statsFrom))) {
+                stats.log->push_back(std::move(generation));
+            }
+        }
+        if (detector) {
+            bool candidate = false;
+            for (const GridFingerprint& fingerprint : mergeFingerprints(workers, static_cast<size_t>(depth))) {
+                candidate |= detector->observe(fingerprint);
+            }
+            if (candidate) break;
+        }
+    }
+    return done;
+}
+
+// `generations` generations with no cycle detection: jumped when it pays
+// and no generation's statistics are wanted, stepped otherwise
+void advancePlain(uint8_t rule, CellWords& cells, CellWords& nextCells, size_t size,
+                  uint64_t generations, WorkerPool& pool, StatsSink stats = StatsSink()) {
+    if (generations == 0) return;
+    const bool mayJump = isJumpRule(rule) && !stats.keepsEvery();
+    if (generations <= INT_MAX && !(mayJump && jumpPays(rule, static_cast<int>(generations)))) {
+        stepGrid(rule, cells, nextCells, size, static_cast<int>(generations), pool, nullptr, stats);
+    } else if (mayJump) {
+        jumpLinear(rule, cells, size * 8, generations, pool);
+    } else {
+        for (; generations > INT_MAX; generations -= INT_MAX) {
+            stepGrid(rule, cells, nextCells, size, INT_MAX, pool, nullptr,
+                     stats.every ? stats : StatsSink());
+        }
+        stepGrid(rule, cells, nextCells, size, static_cast<int>(generations), pool, nullptr, stats);
+    }
+}
+
+// One grid's update(generations) with cycle detection (the detector must be
+// started to detect anything); `stepped` generations of this update were
+// already computed elsewhere. Once a cycle is confirmed the generations are
+// reduced modulo its period. A candidate is confirmed from the current
+// grid: the grid is saved, stepped through the candidate period and
+// compared, and so is any shorter period the fingerprints then suggest.
+// That is done when the generations left or already computed cover the
+// period, so confirming at most doubles an update's work, and otherwise
+// waits for a later update. Jumping ahead (rules 90 and 150)
+// skips generations the detector cannot see, so it stops detection.
+//
+// Statistics go to `stats` in generation order: a confirmation's
+// generations are real ones (and dropped again if it fails), while those
+// served from a known cycle are already in an every-generation log.
+void advanceGrid(uint8_t rule, CellWords& cells, CellWords& nextCells, size_t size, int generations,
+                 WorkerPool& pool, CycleDetector& detector, uint64_t stepped = 0,
+                 StatsSink stats = StatsSink()) {
+    uint64_t remaining = generations > 0 ? static_cast<uint64_t>(generations) : 0;
+    for (;;) {
+        if (detector.pending() && detector.candidatePeriod() <= std::max(remaining, stepped)) {
+            CellWords saved = cells;
+            const size_t logged = stats.log ? stats.log->size() : 0;
+            advancePlain(rule, cells, nextCells, size, detector.candidatePeriod(), pool,
+                         stats.every ? stats : StatsSink());
+            if (std::equal(cells.begin(), cells.end(), saved.begin())) {
+                detector.confirm();
+                // A shorter period the fingerprints suggest is stepped and
+                // compared too; the grid is the same state either way
+                for (uint64_t d = detector.shorterPeriod(); d != 0; d = detector.shorterPeriod()) {
+                    advancePlain(rule, cells, nextCells, size, d, pool);
+                    const bool repeats = std::equal(cells.begin(), cells.end(), saved.begin());
+                    if (!repeats) cells = saved;
+                    detector.verifyPeriod(repeats);
+                }
+            } else {
+                cells.swap(saved);
+                detector.stop();
+                if (stats.log) stats.log->resize(logged);
+            }
+        }
+        if (remaining == 0) return;
+        if (detector.found() || detector.pending()) {
+            advancePlain(rule, cells, nextCells, size,
+                         detector.found() ? remaining % detector.period() : remaining, pool,
+                         detector.found() && stats.every ? StatsSink() : stats);
+            return;
+        }
+        if (!stats.keepsEvery() && jumpPays(rule, static_cast<int>(remaining))) {
+            detector.stop();
+            jumpLinear(rule, cells, size * 8, remaining, pool);
+            return;
+        }
+        const int done = stepGrid(rule, cells, nextCells, size, static_cast<int>(remaining), pool,
+                                  detector.watching() ? &detector : nullptr, stats);
+        remaining -= static_cast<uint64_t>(done);
+        stepped += static_cast<uint64_t>(done);
+    }
+}
+
+} // namespace
+
+CellularAutomataProcessor::CellularAutomataProcessor(size_t size, int rule)
+    : dataSize(size), ruleNumber(rule), cells((size + 7) / 8 + 2), nextCells(cells.size()) {
+    if (rule < 0 || rule > 255) {
+        throw std::runtime_error("CA rule must be between 0 and 255: " + std::to_string(rule));
+    }
+}
+
+void CellularAutomataProcessor::initializeFromCiphertext(const ByteSpan& cipherData) {
     size_t limit = std::min(cipherData.size(), dataSize);
-    for (size_t i = 0; i < limit; i++)
-        grid[i] = cipherData[i];
+    cells.assign((dataSize + 7) / 8 + 2, 0);
+    nextCells.resize(cells.size());
+    streamOrder = false;
+    cycles = CycleDetector();
+    gathering = statsMode;
+    generationCount = 0;
+    statsLog.clear();
+    if (limit > 0) {
+        std::memcpy(cells.data() + 1, cipherData.data(), limit);
+    }
+    for (size_t w = 1; w <= wordCount(); w++) {
+        cells[w] = byteSwap64(cells[w]);
+    }
+    if (gathering == CAStats::Every) {
+        statsLog.push_back(gridStats(cells, dataSize, false));
+    }
 }
 
 uint8_t CellularAutomataProcessor::getRuleByte() const {
-    switch(ruleNumber) {
-        case 30: return 0x1E;
-        case 82: return 0x52;
-        case 110: return 0x6E;
-        case 150: return 0x96;
-        default: return 0x00;
+    return static_cast<uint8_t>(ruleNumber);
+}
+
+void CellularAutomataProcessor::toCellOrder() {
+    requireGrid(cells);
+    if (streamOrder) {
+        swapGridBytes(cells);
+        streamOrder = false;
     }
 }
 
 void CellularAutomataProcessor::updateCA_SIMD() {
-    __m256i ruleVec = _mm256_set1_epi8(getRuleByte());
-    size_t i = 0;
-    for (; i + 32 <= dataSize; i += 32) {
-        __m256i left = (i == 0) ? _mm256_setzero_si256() : _mm256_loadu_si256((__m256i*)&grid[i - 1]);
-        __m256i center = _mm256_loadu_si256((__m256i*)&grid[i]);
-        __m256i right = _mm256_loadu_si256((__m256i*)&grid[i + 1]);
+    update(1);
+}
 
-        __m256i next = _mm256_xor_si256(_mm256_xor_si256(left, center), right);
-        next = _mm256_xor_si256(next, ruleVec);
-        _mm256_storeu_si256((__m256i*)&nextGrid[i], next);
+void CellularAutomataProcessor::update(int generations) {
+    toCellOrder();
+    if (generations <= 0) return;
+    generationCount += static_cast<uint64_t>(generations);
+    if (dataSize == 0) return;
+    if (detectCycles && !cycles.started()) {
+        cycles.start(fingerprintGrid(cells));
     }
+    if (gathering == CAStats::Final) statsLog.clear();
+    advanceGrid(getRuleByte(), cells, nextCells, dataSize, generations, pool, cycles, 0,
+                statsSink(gathering, statsLog));
+}
 
-    // Remaining bytes scalar
-    for (; i < dataSize; i++) {
-        uint8_t left = (i == 0) ? 0 : grid[i - 1];
-        uint8_t right = (i == dataSize - 1) ? 0 : grid[i + 1];
-        nextGrid[i] = (left ^ grid[i] ^ right ^ getRuleByte());
-    }
+GenerationStats CellularAutomataProcessor::stats() const {
+    requireGrid(cells);
+    if (gathering == CAStats::Every) return generationStats(generationCount);
+    if (gathering == CAStats::Final && !statsLog.empty()) return statsLog.back();
+    return gridStats(cells, dataSize, streamOrder);
+}
 
-    grid.swap(nextGrid);
+const GenerationStats& CellularAutomataProcessor::generationStats(uint64_t t) const {
+    return loggedStats(gathering, statsLog, cycles, generationCount, t);
 }
 
 std::vector<uint8_t> CellularAutomataProcessor::extractProcessedData() const {
-    return grid;
+    requireGrid(cells);
+    return copyGridBytes(cells, dataSize, streamOrder);
+}
+
+ByteSpan CellularAutomataProcessor::processedBytes() {
+    requireGrid(cells);
+    if (!streamOrder) {
+        swapGridBytes(cells);
+        streamOrder = true;
+    }
+    return gridBytes(cells, dataSize);
+}
+
+ProcessedData CellularAutomataProcessor::releaseProcessedData() {
+    processedBytes();
+    ProcessedData out(std::move(cells), dataSize);
+    cells.clear();
+    streamOrder = false;
+    return out;
+}
+
+MultiRuleCAProcessor::MultiRuleCAProcessor(size_t size, const std::vector<int>& caRules)
+    : dataSize(size), rules(caRules), initial((size + 7) / 8 + 2), streamOrder(caRules.size(), false),
+      cycles(caRules.size()) {
+    for (int rule : rules) {
+        if (rule < 0 || rule > 255) {
+            throw std::runtime_error("CA rule must be between 0 and 255: " + std::to_string(rule));
+        }
+    }
+}
+
+void MultiRuleCAProcessor::initializeFromCiphertext(const ByteSpan& cipherData) {
+    const size_t words = initial.size() - 2;
+    size_t limit = std::min(cipherData.size(), dataSize);
+    initial.assign(words + 2, 0);
+    if (limit > 0) {
+        std::memcpy(initial.data() + 1, cipherData.data(), limit);
+    }
+    for (size_t w = 1; w <= words; w++) {
+        initial[w] = byteSwap64(initial[w]);
+    }
+    cells.clear();
+    nextCells.clear();
+    streamOrder.assign(rules.size(), false);
+    cycles.assign(rules.size(), CycleDetector());
+    gathering = statsMode;
+    generationCount = 0;
+    statsLogs.assign(rules.size(), {});
+    if (gathering == CAStats::Every) {
+        const GenerationStats start = gridStats(initial, dataSize, false);
+        for (auto& log : statsLogs) log.push_back(start);
+    }
+}
+
+void MultiRuleCAProcessor::update(int generations) {
+    const size_t words = (dataSize + 7) / 8;
+    for (size_t r = 0; r < cells.size(); r++) {
+        requireGrid(cells[r]);
+        if (streamOrder[r]) {
+            swapGridBytes(cells[r]);
+            streamOrder[r] = false;
+        }
+    }
+    if (generations <= 0) return;
+    generationCount += static_cast<uint64_t>(generations);
+    if (words == 0 || rules.empty()) return;
+    if (gathering == CAStats::Final) {
+        for (auto& log : statsLogs) log.clear();
+    }
+
+    // Same tiling as CellularAutomataProcessor::update, with the rules as the
+    // inner loop. On the first pass every rule starts from the shared input,
+    // so each input tile is read from memory once and stays in cache while
+    // all the rules advance their copies of it.
+    bool shared = cells.empty();
+    if (shared) {
+        cells.assign(rules.size(), CellWords(words + 2, 0));
+        if (detectCycles) {
+            const GridFingerprint start = fingerprintGrid(initial);
+            for (CycleDetector& cycle : cycles) cycle.start(start);
+        }
+    }
+
+    // Most rules advance together on the shared tiled passes. Linear rules
+    // that jump and rules with a known or candidate cycle advance on their
+    // own, as do rules that raise a candidate during the passes, for the
+    // generations they have left.
+    std::vector<size_t> stepped;
+    std::vector<std::pair<size_t, int>> alone;  // rule, generations already done
+    for (size_t r = 0; r < rules.size(); r++) {
+        const uint8_t rule = static_cast<uint8_t>(rules[r]);
+        if ((gathering != CAStats::Every && jumpPays(rule, generations)) || cycles[r].found() ||
+            cycles[r].pending()) {
+            if (shared) cells[r] = initial;
+            alone.emplace_back(r, 0);
+        } else {
+            stepped.push_back(r);
+        }
+    }
+
+    const size_t tileCount = (words + TileWords - 1) / TileWords;
+    const uint64_t lastMask = tailMaskFor(dataSize);
+    int done = stepped.empty() ? generations : 0;
+    while (done < generations && !stepped.empty()) {
+        const CycleDetector* watcher = nullptr;
+        for (size_t r : stepped) {
+            if (cycles[r].watching()) watcher = &cycles[r];
+        }
+        const int depth = passDepth(generations - done, watcher);
+        const int statsFrom = gathering == CAStats::Every ? 0 : done + depth == generations ? depth - 1 : depth;
+        const size_t statsSlots = gathering == CAStats::None ? 0 : static_cast<size_t>(depth - statsFrom);
+        const size_t halo = passHalo(depth, statsSlots > 0);
+        if (!shared && nextCells.empty()) {
+            nextCells.assign(rules.size(), CellWords(words + 2, 0));
+        }
+        auto& out = shared ? cells : nextCells;
+
+        // Fingerprints of stepped rule k at generation g are slot k * depth + g,
+        // its statistics slot k * statsSlots + g - statsFrom
+        auto workers = runParallel<TileBuffers>(pool, tileCount, [&](size_t t, TileBuffers& buffers) {
+            const Tile tile = tileAt(t, TileWords, words, halo);
+            if (shared) loadTile(initial.data(), tile, buffers.input);
+            buffers.fingerprints.resize(stepped.size() * static_cast<size_t>(depth));
+            buffers.stats.resize(stepped.size() * statsSlots);
+            for (size_t k = 0; k < stepped.size(); k++) {
+                const size_t r = stepped[k];
+                if (shared) {
+                    buffers.tile = buffers.input;
+                } else {
+                    loadTile(cells[r].data(), tile, buffers.tile);
+                }
+                TileRecord record;
+                if (statsSlots > 0) {
+                    record = statsRecord(tile, words, dataSize, &buffers.stats[k * statsSlots], statsFrom);
+                }
+                if (cycles[r].watching()) {
+                    record.fingerprints = &buffers.fingerprints[k * static_cast<size_t>(depth)];
+                }
+                advanceTile(static_cast<uint8_t>(rules[r]), buffers.tile, buffers.spare, tile, depth,
+                            tile.hi == words + 1 ? lastMask : ~0ULL, record);
+                storeTile(buffers.tile, tile, out[r].data());
+            }
+        });
+
+        if (!shared) {
+            for (size_t r : stepped) cells[r].swap(nextCells[r]);
+        }
+        shared = false;
+        done += depth;
+
+        const auto fingerprints = mergeFingerprints(workers, stepped.size() * static_cast<size_t>(depth));
+        auto generationStats = mergeStats(workers, stepped.size() * statsSlots);
+        std::vector<size_t> still;
+        for (size_t k = 0; k < stepped.size(); k++) {
+            const size_t r = stepped[k];
+            for (size_t g = 0; g < statsSlots; g++) {
+                statsLogs[r].push_back(std::move(generationStats[k * statsSlots + g]));
+            }
+            bool candidate = false;
+            for (int g = 0; g < depth && cycles[r].watching(); g++) {
+                candidate |= cycles[r].observe(fingerprints[k * static_cast<size_t>(depth) + g]);
+            }
+            if (candidate || cycles[r].pending()) {
+                alone.emplace_back(r, done);
+            } else {
+                still.push_back(r);
+            }
+        }
+        stepped.swap(still);
+    }
+    CellWords().swap(initial);
+
+    CellWords spare;
+    if (nextCells.empty() && !alone.empty()) spare.assign(words + 2, 0);
+    for (const auto& [r, from] : alone) {
+        advanceGrid(static_cast<uint8_t>(rules[r]), cells[r], nextCells.empty() ? spare : nextCells[r],
+                    dataSize, generations - from, pool, cycles[r], static_cast<uint64_t>(from),
+                    statsSink(gathering, statsLogs[r]));
+    }
+}
+
+const CellWords& MultiRuleCAProcessor::grid(size_t index) const {
+    if (index >= rules.size()) {
+        throw std::runtime_error("Rule index out of range: " + std::to_string(index));
+    }
+    if (cells.empty()) return initial;
+    requireGrid(cells[index]);
+    return cells[index];
+}
+
+// Gives every rule its own copy of the input (update(0) then a view)
+void MultiRuleCAProcessor::splitInitial() {
+    if (cells.empty()) {
+        cells.assign(rules.size(), initial);
+        CellWords().swap(initial);
+    }
+}
+
+GenerationStats MultiRuleCAProcessor::stats(size_t index) const {
+    const CellWords& source = grid(index);
+    if (gathering == CAStats::Every) return generationStats(index, generationCount);
+    if (gathering == CAStats::Final && !statsLogs[index].empty()) return statsLogs[index].back();
+    return gridStats(source, dataSize, !cells.empty() && streamOrder[index]);
+}
+
+const GenerationStats& MultiRuleCAProcessor::generationStats(size_t index, uint64_t t) const {
+    return loggedStats(gathering, statsLogs.at(index), cycles.at(index), generationCount, t);
+}
+
+std::vector<uint8_t> MultiRuleCAProcessor::extractProcessedData(size_t index) const {
+    const CellWords& source = grid(index);
+    return copyGridBytes(source, dataSize, !cells.empty() && streamOrder[index]);
+}
+
+ByteSpan MultiRuleCAProcessor::processedBytes(size_t index) {
+    grid(index);
+    splitInitial();
+    if (!streamOrder[index]) {
+        swapGridBytes(cells[index]);
+        streamOrder[index] = true;
+    }
+    return gridBytes(cells[index], dataSize);
+}
+
+ProcessedData MultiRuleCAProcessor::releaseProcessedData(size_t index) {
+    processedBytes(index);
+    ProcessedData out(std::move(cells[index]), dataSize);
+    cells[index].clear();
+    streamOrder[index] = false;
+    return out;
 }
@@ -3,30 +3,214 @@
 
 #include <vector>
 #include <cstdint>
-#include <immintrin.h>
+#include <utility>
+#include "aligned_allocator.hpp"
+#include "byte_span.hpp"
+#include "ca_cycle.hpp"
+#include "ca_stats.hpp"
+#include "worker_pool.hpp"
 
+// A CA result moved out of its processor: the grid's own words, turned into
+// stream-order bytes in place. Converts to ByteSpan like a vector does.
+class ProcessedData {
+public:
+    ProcessedData(CellWords grid, size_t size) : words(std::move(grid)), count(size) {}
+
+    const uint8_t* data() const { return reinterpret_cast<const uint8_t*>(words.data() + 1); }
+    size_t size() const { return count; }
+    ByteSpan bytes() const { return ByteSpan(data(), count); }
+    operator ByteSpan() const { return bytes(); }
+
+private:
+    CellWords words;  // [guard | data | guard]
+    size_t count;
+};
+
+// Elementary (radius-1, two-state) cellular automaton over the bits of the
+// ciphertext. Every bit is a cell in stream order (bit 7 of byte 0 first), its
+// neighbours are the bits on either side across byte and word boundaries,
+// and cells beyond either end read as 0. Any Wolfram rule 0-255 is supported:
+// the new state of a cell is bit (4*left + 2*centre + right) of the rule.
+//
+// The cells are kept in 64-bit words (first cell in the top bit) with a zero
+// guard word at each end, and the rule is applied bit-sliced to whole words,
+// so one AVX-512 ternary-logic instruction updates 512 cells at once and an
+// AVX2 register 256; the widest kernel the CPU supports is picked at run
+// time. Large grids are split into tiles that worker threads advance
+// independently between halo refreshes. The grid is 64-byte aligned and large
+// grids ask for huge pages (aligned_allocator.hpp).
 class CellularAutomataProcessor {
 private:
     size_t dataSize;
     int ruleNumber;
-    std::vector<uint8_t> grid;
-    std::vector<uint8_t> nextGrid;
+    WorkerPool pool;                  // update()'s worker threads
+    bool streamOrder = false;         // cells byte-swapped for processedBytes()
+    bool detectCycles = false;
+    CAStats statsMode = CAStats::None;
+    CAStats gathering = CAStats::None;  // statsMode as of the last initialization
+    uint64_t generationCount = 0;
+    CellWords cells;                  // [guard | words | guard]
+    CellWords nextCells;
+    CycleDetector cycles;
+    std::vector<GenerationStats> statsLog;  // per generation, or the last update's last
+
+    size_t wordCount() const { return cells.size() - 2; }
+    void toCellOrder();
 
 public:
-    // Constructor
+    // Constructor; throws std::runtime_error for rules outside 0-255
     CellularAutomataProcessor(size_t size, int rule);
 
-    // Initialize the grid from ciphertext
-    void initializeFromCiphertext(const std::vector<uint8_t>& cipherData);
+    // Initialize the grid from ciphertext (a vector or a mapped file)
+    void initializeFromCiphertext(const ByteSpan& cipherData);
+
+    // Worker threads for update(int); 0 (the default) uses every core
+    void setThreads(unsigned threads) { pool.setThreads(threads); }
+
+    // Cache tiling for update(): words per tile (the two 8 KiB tile buffers
+    // stay in L1, which the kernels can outrun L2 without) and generations
+    // fused per pass over the grid
+    static constexpr size_t TileWords = 1024;
+    static constexpr int MaxBlockDepth = 256;
 
-    // Update the cellular automata using SIMD
+    // Rules 90 and 150 are linear over GF(2), so update() can compute
+    // generation t directly by repeated squaring, in one pass over the grid
+    // per set bit of t. A pass costs about as much as this many stepped
+    // generations and setting up costs about four passes; update() jumps
+    // when that comes out cheaper than stepping.
+    static constexpr int JumpPassGenerations = 16;
+
+    // Cycle detection (off by default, as fingerprinting every generation
+    // slows each tile pass down; a change applies from the next
+    // initialization). Every generation update() computes is fingerprinted
+    // in the same tile pass and fed to Brent's algorithm (ca_cycle.hpp);
+    // once the grid is confirmed to repeat, update() stops stepping and
+    // serves any further generations from the cycle. Jumping ahead is not
+    // seen by the detector, so it ends detection for rules 90 and 150.
+    void setCycleDetection(bool enabled) { detectCycles = enabled; }
+    const CycleDetector& cycle() const { return cycles; }
+
+    // While detection watches, a tiled pass runs at most as many generations
+    // as have been fingerprinted so far (and at least this many), so a cycle
+    // that shows up early is not stepped through a full MaxBlockDepth pass
+    static constexpr int MinWatchDepth = 16;
+
+    // Statistics gathering (off by default; a change applies from the next
+    // initialization). update() then takes the byte histogram, lag-1
+    // products and cell transitions of the generations it computes in the
+    // tile passes that compute them (ca_stats.hpp), so stats() costs no pass
+    // over the data. CAStats::Every keeps every generation's, about 2 KiB
+    // each, and steps rules 90 and 150 instead of jumping.
+    void setStats(CAStats mode) { statsMode = mode; }
+
+    // Statistics of the current generation, as ByteStats::add over
+    // processedBytes() would give them, plus its transitions. Gathered by the
+    // last update when it could (not past a jump, or a cycle that left
+    // nothing to step); otherwise, and with gathering off, computed from the
+    // grid.
+    GenerationStats stats() const;
+
+    // Statistics of generation t, 0 (the input) to generation(); needs
+    // CAStats::Every. Generations past a detected cycle are served from it.
+    // Throws std::runtime_error otherwise.
+    const GenerationStats& generationStats(uint64_t t) const;
+
+    // Generations advanced since initialization
+    uint64_t generation() const { return generationCount; }
+
+    // Advance every cell by one generation
     void updateCA_SIMD();
 
-    // Get rule byte for specific rules
+    // Advance every cell by `generations` generations. Large grids are
+    // processed tile by tile, each tile running several generations while it
+    // is in cache, so the grid crosses the memory bus once per pass instead
+    // of once per generation; the tiles of a pass are shared out among the
+    // worker threads. Rules 90 and 150 jump ahead instead when it pays, and
+    // generations past a detected cycle are not computed. Same result as
+    // calling updateCA_SIMD() in a loop.
+    void update(int generations);
+
+    // Rule table: bit k is the next state for neighbourhood k = 4l + 2c + r
     uint8_t getRuleByte() const;
 
-    // Extract processed data
+    // Copy of the processed data
     std::vector<uint8_t> extractProcessedData() const;
+
+    // The processed data without copying: the grid words are byte-swapped in
+    // place into stream order and viewed directly. The view is valid until
+    // the next update or initialization (which swap them back).
+    ByteSpan processedBytes();
+
+    // Moves the grid out as the result. The processor must be initialized
+    // again before further use; throws std::runtime_error until then.
+    ProcessedData releaseProcessedData();
+};
+
+// The same elementary CA run under several rules at once, for rule sweeps.
+// Generations are computed tile by tile as in CellularAutomataProcessor, with
+// all the rules advancing one tile before moving to the next, so the first
+// pass reads the ciphertext from memory once rather than once per rule.
+// Output i is bit-identical to a CellularAutomataProcessor with rules[i].
+class MultiRuleCAProcessor {
+public:
+    // Throws std::runtime_error for rules outside 0-255
+    MultiRuleCAProcessor(size_t size, const std::vector<int>& rules);
+
+    void initializeFromCiphertext(const ByteSpan& cipherData);
+
+    // Worker threads for update(); 0 (the default) uses every core
+    void setThreads(unsigned threads) { pool.setThreads(threads); }
+
+    static constexpr size_t TileWords = CellularAutomataProcessor::TileWords;
+    static constexpr int MaxBlockDepth = CellularAutomataProcessor::MaxBlockDepth;
+    static constexpr int JumpPassGenerations = CellularAutomataProcessor::JumpPassGenerations;
+    static constexpr int MinWatchDepth = CellularAutomataProcessor::MinWatchDepth;
+
+    // Per-rule cycle detection, as in CellularAutomataProcessor
+    void setCycleDetection(bool enabled) { detectCycles = enabled; }
+    const CycleDetector& cycle(size_t index) const { return cycles.at(index); }
+
+    // Per-rule statistics, as in CellularAutomataProcessor; the shared
+    // passes gather every rule's in the same tile visit
+    void setStats(CAStats mode) { statsMode = mode; }
+    GenerationStats stats(size_t index) const;
+    const GenerationStats& generationStats(size_t index, uint64_t t) const;
+    uint64_t generation() const { return generationCount; }
+
+    // Advance every rule's grid by `generations` generations; rules 90 and
+    // 150 jump ahead and rules in a detected cycle are served from it, as in
+    // CellularAutomataProcessor::update. A rule whose cycle turns up during
+    // the shared passes leaves them.
+    void update(int generations);
+
+    size_t ruleCount() const { return rules.size(); }
+    int getRule(size_t index) const { return rules[index]; }
+
+    // Processed data for rules[index]: a copy, a view valid until the next
+    // update or initialization, or the grid moved out (after which rule
+    // `index` is unusable until initializeFromCiphertext), as in
+    // CellularAutomataProcessor
+    std::vector<uint8_t> extractProcessedData(size_t index) const;
+    ByteSpan processedBytes(size_t index);
+    ProcessedData releaseProcessedData(size_t index);
+
+private:
+    size_t dataSize;
+    std::vector<int> rules;
+    WorkerPool pool;
+    bool detectCycles = false;
+    CAStats statsMode = CAStats::None;
+    CAStats gathering = CAStats::None;
+    uint64_t generationCount = 0;
+    CellWords initial;                  // shared input until the first update
+    std::vector<CellWords> cells;       // one guarded grid per rule after it
+    std::vector<CellWords> nextCells;
+    std::vector<bool> streamOrder;      // per rule, as in CellularAutomataProcessor
+    std::vector<CycleDetector> cycles;
+    std::vector<std::vector<GenerationStats>> statsLogs;
+
+    void splitInitial();
+    const CellWords& grid(size_t index) const;
 };
 
-#endif // CA_ANALYZER_HPP
\ No newline at end of file
+#endif // CA_ANALYZER_HPP
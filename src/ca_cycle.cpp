@@ -0,0 +1,82 @@
+#include "ca_cycle.hpp"
+#include "ca_kernels.hpp"
+
+GridFingerprint fingerprintRange(const uint64_t* words, size_t first, size_t last, uint64_t offset) {
+    using namespace simd_kernels;
+    GridFingerprint fingerprint;
+    size_t w = first;
+    switch (simdLevel()) {
+        case SimdLevel::AVX512: w = fingerprintAvx512(words, w, last, offset, fingerprint.sum, fingerprint.mix); break;
+        case SimdLevel::AVX2: w = fingerprintAvx2(words, w, last, offset, fingerprint.sum, fingerprint.mix); break;
+        case SimdLevel::SSE2: w = fingerprintSse2(words, w, last, offset, fingerprint.sum, fingerprint.mix); break;
+        case SimdLevel::Scalar: break;
+    }
+    fingerprintWords<ScalarOps>(words, w, last, offset, fingerprint.sum, fingerprint.mix);
+    return fingerprint;
+}
+
+void CycleDetector::start(const GridFingerprint& initial) {
+    *this = CycleDetector();
+    state = State::Watching;
+    history.push_back(initial);
+    tortoise = initial;
+}
+
+void CycleDetector::stop() {
+    if (state == State::Found) return;
+    state = State::Stopped;
+    std::vector<GridFingerprint>().swap(history);
+}
+
+bool CycleDetector::observe(const GridFingerprint& fingerprint) {
+    if (state != State::Watching && state != State::Candidate) return false;
+    history.push_back(fingerprint);
+    if (state == State::Candidate) return false;
+
+    distance++;
+    if (fingerprint == tortoise) {
+        state = State::Candidate;
+        candidate = history.size() - 1;
+        return true;
+    }
+    if (distance == power) {
+        tortoise = fingerprint;
+        power *= 2;
+        distance = 0;
+    }
+    return false;
+}
+
+void CycleDetector::confirm() {
+    if (state != State::Candidate) return;
+    state = State::Found;
+    periodLength = distance;
+    verifyPeriod(false);
+}
+
+void CycleDetector::verifyPeriod(bool repeats) {
+    if (state != State::Found || history.empty()) return;
+    if (repeats) {
+        periodLength = shorter;
+    }
+    const uint64_t rejected = repeats ? 0 : shorter;
+    shorter = 0;
+    if (!repeats) {
+        for (uint64_t d = rejected + 1; d < periodLength; d++) {
+            if (periodLength % d == 0 && history[candidate - d] == history[candidate]) {
+                shorter = d;
+                return;
+            }
+        }
+    }
+
+    // The period is settled: no divisor left to try, or a verified one
+    // (which is as short as the fingerprints allow, as all shorter ones
+    // failed to match or were rejected)
+    transientLength = 0;
+    while (transientLength + periodLength + 1 < history.size() &&
+           history[transientLength] != history[transientLength + periodLength]) {
+        transientLength++;
+    }
+    std::vector<GridFingerprint>().swap(history);
+}
@@ -0,0 +1,89 @@
+#ifndef CA_CYCLE_HPP
+#define CA_CYCLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 128-bit fingerprint of one CA generation (fingerprintWords in
+// ca_kernels.hpp). Parts of a grid are fingerprinted separately and merged.
+struct GridFingerprint {
+    uint64_t sum = 0;
+    uint64_t mix = 0;
+
+    void merge(const GridFingerprint& part) {
+        sum += part.sum;
+        mix ^= part.mix;
+    }
+    bool operator==(const GridFingerprint& other) const { return sum == other.sum && mix == other.mix; }
+    bool operator!=(const GridFingerprint& other) const { return !(*this == other); }
+};
+
+// Fingerprint of words[first, last) with the widest kernel available, word
+// i keyed by i + offset (pass the word's index in the grid's data)
+GridFingerprint fingerprintRange(const uint64_t* words, size_t first, size_t last, uint64_t offset);
+
+// Brent's cycle detection over the generations of one CA grid, on
+// fingerprints. The processor reports every generation it computes; the
+// tortoise is the fingerprint of generation 0, 1, 3, 7, 15, ..., and the
+// first later generation that matches it is a candidate cycle. A candidate
+// is only a fingerprint match: the processor confirms it by stepping the
+// grid through the candidate period and comparing (confirm()), or drops
+// detection if the grids differ (stop()). Once confirmed, any number of
+// further generations is served as that number modulo the period.
+class CycleDetector {
+public:
+    // Begin at generation 0 (an initialized grid)
+    void start(const GridFingerprint& initial);
+
+    // Stop watching, e.g. because generations were jumped over unseen
+    void stop();
+
+    bool started() const { return state != State::Idle; }
+    bool watching() const { return state == State::Watching; }
+    bool pending() const { return state == State::Candidate; }
+    bool found() const { return state == State::Found; }
+
+    // Generations recorded since start()
+    uint64_t generation() const { return history.empty() ? 0 : history.size() - 1; }
+
+    // Records the fingerprint of the next generation. Returns true when it
+    // makes a candidate; later generations are still recorded.
+    bool observe(const GridFingerprint& fingerprint);
+
+    // Generations between the tortoise and the candidate generation
+    uint64_t candidatePeriod() const { return distance; }
+
+    // The grid came back to the same state after candidatePeriod()
+    // generations, which becomes the period
+    void confirm();
+
+    // After confirm(): the next shorter period the fingerprints suggest (the
+    // smallest divisor of the period, above any rejected one, at which they
+    // repeat), or 0 when there is none. The processor steps the grid that
+    // many generations and reports whether it came back (verifyPeriod), so
+    // the period only ever shrinks to one the grid itself repeats at.
+    uint64_t shorterPeriod() const { return shorter; }
+    void verifyPeriod(bool repeats);
+
+    // Generations before the cycle and its length; a fixed point has period
+    // 1. The transient is read off the fingerprints and only reported;
+    // nothing is computed from it.
+    uint64_t transient() const { return transientLength; }
+    uint64_t period() const { return periodLength; }
+
+private:
+    enum class State { Idle, Watching, Candidate, Stopped, Found };
+
+    State state = State::Idle;
+    std::vector<GridFingerprint> history;   // generations 0, 1, 2, ...
+    GridFingerprint tortoise;
+    uint64_t power = 1;                     // tortoise moves when distance reaches it
+    uint64_t distance = 0;                  // generations since the tortoise
+    uint64_t candidate = 0;                 // generation that matched it
+    uint64_t shorter = 0;                   // period to verify next, 0 = none
+    uint64_t transientLength = 0;
+    uint64_t periodLength = 0;
+};
+
+#endif // CA_CYCLE_HPP
@@ -0,0 +1,119 @@
+#include "ca_denoiser.hpp"
+#include "simd_kernels.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+bool isNoise(uint8_t v) {
+    return v == 0 || v == 255;
+}
+
+// Cell i of a line of n cells, reflected about both ends (-1 reads as 0)
+size_t mirror(long long i, size_t n) {
+    const long long period = 2 * static_cast<long long>(n);
+    i %= period;
+    if (i < 0) i += period;
+    return static_cast<size_t>(i < static_cast<long long>(n) ? i : period - 1 - i);
+}
+
+} // namespace
+
+CADenoiser::CADenoiser(size_t width, size_t size)
+    : width(width), height(width ? (size + width - 1) / width : 0), dataSize(size) {
+    if (width == 0) {
+        throw std::runtime_error("Denoiser width must be positive");
+    }
+    pixels.assign(height * width, 0);
+    nextPixels.assign(pixels.size(), 0);
+}
+
+void CADenoiser::initializeFromCiphertext(const ByteSpan& cipherData) {
+    size_t limit = std::min(cipherData.size(), dataSize);
+    std::fill(pixels.begin(), pixels.end(), 0);
+    if (limit > 0) {
+        std::memcpy(pixels.data(), cipherData.data(), limit);
+    }
+}
+
+const uint8_t* CADenoiser::row(long long y) const {
+    const size_t source = y >= 0 && y < static_cast<long long>(height) ? static_cast<size_t>(y) : mirror(y, height);
+    return pixels.data() + source * width;
+}
+
+// Lower median of the noise-free cells of the smallest window around (x, y)
+// that has any, starting at radius `from` (the smaller windows are known to
+// be all noise); the cell itself if none within MaxRadius. Each window size
+// only adds its outer ring.
+uint8_t CADenoiser::adaptiveMedian(size_t x, size_t y, int from) const {
+    uint8_t window[8 * MaxRadius];
+    for (int r = from; r <= MaxRadius; r++) {
+        size_t count = 0;
+        for (long long dy = -r; dy <= r; dy++) {
+            const uint8_t* line = row(static_cast<long long>(y) + dy);
+            const long long step = (dy == -r || dy == r) ? 1 : 2 * r;
+            for (long long dx = -r; dx <= r; dx += step) {
+                long long column = static_cast<long long>(x) + dx;
+                uint8_t v = line[column >= 0 && column < static_cast<long long>(width)
+                                     ? static_cast<size_t>(column) : mirror(column, width)];
+                if (!isNoise(v)) window[count++] = v;
+            }
+        }
+        if (count > 0) {
+            std::nth_element(window, window + (count - 1) / 2, window + count);
+            return window[(count - 1) / 2];
+        }
+    }
+    return pixels[y * width + x];
+}
+
+void CADenoiser::update() {
+    using namespace simd_kernels;
+    if (dataSize == 0) return;
+    const SimdLevel level = simdLevel();
+    for (size_t y = 0; y < height; y++) {
+        const long long yy = static_cast<long long>(y);
+        const uint8_t* centre = row(yy);
+        uint8_t* out = nextPixels.data() + y * width;
+
+        // Interior columns [1, stop) by the kernels, which flag cells whose
+        // 3x3 window is all noise
+        size_t stop = 1;
+        bool pending = false;
+        if (width >= 3) {
+            switch (level) {
+                case SimdLevel::AVX512:
+                case SimdLevel::AVX2:
+                    stop = medianRowAvx2(row(yy - 1), centre, row(yy + 1), out, 1, width - 1, pending);
+                    break;
+                case SimdLevel::SSE2:
+                    stop = medianRowSse2(row(yy - 1), centre, row(yy + 1), out, 1, width - 1, pending);
+                    break;
+                case SimdLevel::Scalar: break;
+            }
+        }
+
+        for (size_t x = 0; x < width; x = (x == 0 ? stop : x + 1)) {
+            out[x] = isNoise(centre[x]) ? adaptiveMedian(x, y, 1) : centre[x];
+        }
+        if (pending) {
+            for (size_t x = 1; x < stop; x++) {
+                if (isNoise(out[x])) out[x] = adaptiveMedian(x, y, 2);
+            }
+        }
+    }
+    pixels.swap(nextPixels);
+}
+
+void CADenoiser::update(int generations) {
+    for (int g = 0; g < generations; g++) update();
+}
+
+size_t CADenoiser::noisyCount() const {
+    return static_cast<size_t>(std::count_if(pixels.begin(), pixels.begin() + dataSize, isNoise));
+}
+
+std::vector<uint8_t> CADenoiser::extractProcessedData() const {
+    return std::vector<uint8_t>(pixels.begin(), pixels.begin() + dataSize);
+}
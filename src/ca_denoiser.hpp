@@ -0,0 +1,63 @@
+#ifndef CA_DENOISER_HPP
+#define CA_DENOISER_HPP
+
+#include <vector>
+#include <cstdint>
+#include "aligned_allocator.hpp"
+#include "byte_span.hpp"
+
+// Adaptive salt-and-pepper denoiser as a byte-valued 2D cellular automaton
+// (the CA filter of "An improved cellular automata based image denoising
+// method for biometric applications"). The bytes are grey-level pixels laid
+// out row by row, `width` to a row. A cell is noisy if it is 0 or 255; each
+// generation replaces every noisy cell with the median of the noise-free
+// cells in the smallest of its 3x3, 5x5 and 7x7 windows that has any, with
+// cells outside the image mirrored (cell -1 reads as cell 0). A noisy cell
+// with no noise-free cell within 7x7 keeps its value and is retried in the
+// next generation, once its neighbours have been restored. Noise-free cells
+// never change.
+//
+// The 3x3 windows, which settle almost every cell at practical noise
+// densities, are filtered 16 or 32 pixels at a time by sorting-network
+// kernels (SSE2 or AVX2, chosen at run time); border columns and the larger
+// windows take the scalar path.
+class CADenoiser {
+public:
+    // `size` bytes in rows of `width`; a final partial row is padded with
+    // noise. Throws std::runtime_error for width 0.
+    CADenoiser(size_t width, size_t size);
+
+    // Initialize the pixels from ciphertext (a vector or a mapped file)
+    void initializeFromCiphertext(const ByteSpan& cipherData);
+
+    static constexpr int MaxRadius = 3;  // 7x7
+
+    // Run one or `generations` filter generations
+    void update();
+    void update(int generations);
+
+    // Noisy cells left among the first `size`
+    size_t noisyCount() const;
+
+    size_t getWidth() const { return width; }
+    size_t getHeight() const { return height; }
+
+    // The first `size` pixels, as a view valid until the next update or
+    // initialization, or as a copy
+    ByteSpan processedBytes() const { return ByteSpan(pixels.data(), dataSize); }
+    std::vector<uint8_t> extractProcessedData() const;
+
+private:
+    using Pixels = std::vector<uint8_t, AlignedAllocator<uint8_t>>;
+
+    size_t width;
+    size_t height;
+    size_t dataSize;
+    Pixels pixels;
+    Pixels nextPixels;
+
+    const uint8_t* row(long long y) const;
+    uint8_t adaptiveMedian(size_t x, size_t y, int from) const;
+};
+
+#endif // CA_DENOISER_HPP
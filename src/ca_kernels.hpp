@@ -0,0 +1,207 @@
+// ca_kernels.hpp
+#pragma once
+#include "simd_kernels.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Generation kernels of the 1D and 2D CA, written once against a small set
+// of word-wide operations (Ops::V holds Ops::Lanes words) and instantiated
+// per instruction set: ScalarOps in ca_analyzer.cpp and ca2d_processor.cpp,
+// the vector Ops in the simd_kernels_*.cpp units. Each unit instantiates
+// only its own Ops, so no vector code can leak into the scalar path at link
+// time.
+namespace simd_kernels {
+
+// Word-wide operations on one 64-bit word
+struct ScalarOps {
+    using V = uint64_t;
+    static constexpr size_t Lanes = 1;
+    static V load(const uint64_t* p) { return *p; }
+    static void store(uint64_t* p, V v) { *p = v; }
+    static V set1(uint64_t x) { return x; }
+    static V andV(V a, V b) { return a & b; }
+    static V orV(V a, V b) { return a | b; }
+    static V xorV(V a, V b) { return a ^ b; }
+    static V andNot(V a, V b) { return ~a & b; }
+    static V shr1(V a) { return a >> 1; }
+    static V shl1(V a) { return a << 1; }
+    static V shr63(V a) { return a >> 63; }
+    static V shl63(V a) { return a << 63; }
+    static V shr32(V a) { return a >> 32; }
+    static V add64(V a, V b) { return a + b; }
+    static V mulLow32(V a, V b) { return (a & 0xFFFFFFFFULL) * (b & 0xFFFFFFFFULL); }
+};
+
+// Output of Wolfram rule `Rule` for left/centre pair LC = 2l + c, as a
+// function of the right neighbour: constant 0 or 1, r or ~r
+template <int Rule, int LC, typename Ops>
+typename Ops::V ruleHalf(typename Ops::V r) {
+    constexpr int whenClear = (Rule >> (2 * LC)) & 1;
+    constexpr int whenSet = (Rule >> (2 * LC + 1)) & 1;
+    if constexpr (whenClear == whenSet) {
+        return Ops::set1(whenSet ? ~0ULL : 0);
+    } else if constexpr (whenSet) {
+        return r;
+    } else {
+        return Ops::andNot(r, Ops::set1(~0ULL));
+    }
+}
+
+// s ? a : b, bitwise
+template <typename Ops>
+typename Ops::V selectV(typename Ops::V s, typename Ops::V a, typename Ops::V b) {
+    return Ops::xorV(b, Ops::andV(s, Ops::xorV(a, b)));
+}
+
+// Next state of the cells in c with neighbours l and r: a multiplexer tree on
+// r, then c, then l. With the rule a template argument the constant inputs
+// fold away at compile time, leaving a short formula per rule (rule 30
+// reduces to about a third of the generic tree's operations).
+template <int Rule, typename Ops>
+typename Ops::V elementaryRule(typename Ops::V l, typename Ops::V c, typename Ops::V r) {
+    return selectV<Ops>(l, selectV<Ops>(c, ruleHalf<Rule, 3, Ops>(r), ruleHalf<Rule, 2, Ops>(r)),
+                        selectV<Ops>(c, ruleHalf<Rule, 1, Ops>(r), ruleHalf<Rule, 0, Ops>(r)));
+}
+
+// One elementary generation of in[first, last) into out; in[first - 1] and
+// in[last] are read as neighbours
+template <int Rule, typename Ops>
+size_t stepElementary(const uint64_t* in, uint64_t* out, size_t first, size_t last) {
+    using V = typename Ops::V;
+    size_t w = first;
+    for (; w + Ops::Lanes <= last; w += Ops::Lanes) {
+        V c = Ops::load(in + w);
+        V l = Ops::orV(Ops::shr1(c), Ops::shl63(Ops::load(in + w - 1)));
+        V r = Ops::orV(Ops::shl1(c), Ops::shr63(Ops::load(in + w + 1)));
+        Ops::store(out + w, elementaryRule<Rule, Ops>(l, c, r));
+    }
+    return w;
+}
+
+using ElementaryKernel = size_t (*)(const uint64_t*, uint64_t*, size_t, size_t);
+
+// stepElementary<Rule, Ops> for every rule, indexed by rule number
+template <typename Ops, size_t... Rules>
+constexpr std::array<ElementaryKernel, sizeof...(Rules)> elementaryKernels(std::index_sequence<Rules...>) {
+    return {{&stepElementary<static_cast<int>(Rules), Ops>...}};
+}
+
+// Fingerprint of a run of grid words for cycle detection (ca_cycle.hpp).
+// Word i is keyed twice, as x = words[i] ^ (i + offset) * FingerprintKey
+// and y = words[i] ^ (i + offset) * MixKey; lo32(x) * hi32(x) is added to
+// `sum` and lo32(y) * hi32(y) xored into `mix`. The products keep each half
+// dependent on both the word and its position, and both halves merge in
+// any order, so vector lanes, tiles and threads are fingerprinted
+// separately.
+constexpr uint64_t FingerprintKey = 0x9E3779B97F4A7C15ULL;
+constexpr uint64_t MixKey = 0xC2B2AE3D27D4EB4FULL;
+
+template <typename Ops>
+size_t fingerprintWords(const uint64_t* words, size_t first, size_t last, uint64_t offset,
+                        uint64_t& sum, uint64_t& mix) {
+    using V = typename Ops::V;
+    uint64_t lanes[Ops::Lanes];
+    for (size_t k = 0; k < Ops::Lanes; k++) lanes[k] = (first + k + offset) * FingerprintKey;
+    V sumKey = Ops::load(lanes);
+    for (size_t k = 0; k < Ops::Lanes; k++) lanes[k] = (first + k + offset) * MixKey;
+    V mixKey = Ops::load(lanes);
+    const V sumStep = Ops::set1(Ops::Lanes * FingerprintKey);
+    const V mixStep = Ops::set1(Ops::Lanes * MixKey);
+    V s = Ops::set1(0), m = Ops::set1(0);
+
+    size_t w = first;
+    for (; w + Ops::Lanes <= last; w += Ops::Lanes) {
+        const V word = Ops::load(words + w);
+        const V x = Ops::xorV(word, sumKey);
+        const V y = Ops::xorV(word, mixKey);
+        s = Ops::add64(s, Ops::mulLow32(x, Ops::shr32(x)));
+        m = Ops::xorV(m, Ops::mulLow32(y, Ops::shr32(y)));
+        sumKey = Ops::add64(sumKey, sumStep);
+        mixKey = Ops::add64(mixKey, mixStep);
+    }
+    Ops::store(lanes, s);
+    for (uint64_t lane : lanes) sum += lane;
+    Ops::store(lanes, m);
+    for (uint64_t lane : lanes) mix ^= lane;
+    return w;
+}
+
+// Rule as all-ones/all-zeros words per 3x3 count k (the cell included): a
+// dead cell with count k is born if birth has k, a live one survives if
+// survive has k - 1
+struct MooreRuleWords {
+    uint64_t born[10];
+    uint64_t kept[10];
+};
+
+// Vertical pass: 2-bit column sums of rows up/centre/down, words [first, last)
+template <typename Ops>
+size_t sumColumns(const uint64_t* up, const uint64_t* centre, const uint64_t* down,
+                  uint64_t* a0, uint64_t* a1, size_t first, size_t last) {
+    using V = typename Ops::V;
+    size_t w = first;
+    for (; w + Ops::Lanes <= last; w += Ops::Lanes) {
+        V u = Ops::load(up + w), c = Ops::load(centre + w), d = Ops::load(down + w);
+        V uc = Ops::xorV(u, c);
+        Ops::store(a0 + w, Ops::xorV(uc, d));
+        Ops::store(a1 + w, Ops::orV(Ops::andV(u, c), Ops::andV(d, uc)));
+    }
+    return w;
+}
+
+// Horizontal pass: add the column sums left, centre and right of every cell
+// and apply the rule. a0/a1 are indexed with one edge word in front, so
+// word w of the row is a0[w + 1].
+template <typename Ops>
+size_t applyRule(const uint64_t* a0, const uint64_t* a1, const uint64_t* centre,
+                 uint64_t* out, size_t first, size_t last, const MooreRuleWords& rule) {
+    using V = typename Ops::V;
+    V born[10], kept[10];
+    for (int k = 0; k < 10; k++) {
+        born[k] = Ops::set1(rule.born[k]);
+        kept[k] = Ops::set1(rule.kept[k]);
+    }
+
+    size_t w = first;
+    for (; w + Ops::Lanes <= last; w += Ops::Lanes) {
+        V p0 = Ops::load(a0 + w), x0 = Ops::load(a0 + w + 1), n0 = Ops::load(a0 + w + 2);
+        V p1 = Ops::load(a1 + w), x1 = Ops::load(a1 + w + 1), n1 = Ops::load(a1 + w + 2);
+
+        // Columns to the west (cell x - 1) and east (cell x + 1)
+        V w0 = Ops::orV(Ops::shr1(x0), Ops::shl63(p0));
+        V e0 = Ops::orV(Ops::shl1(x0), Ops::shr63(n0));
+        V w1 = Ops::orV(Ops::shr1(x1), Ops::shl63(p1));
+        V e1 = Ops::orV(Ops::shl1(x1), Ops::shr63(n1));
+
+        // Three 2-bit numbers into a 4-bit count t3 t2 t1 t0 (0-9)
+        V s0 = Ops::xorV(w0, x0);
+        V t0 = Ops::xorV(s0, e0);
+        V c0 = Ops::orV(Ops::andV(w0, x0), Ops::andV(e0, s0));
+        V s1 = Ops::xorV(w1, x1);
+        V u1 = Ops::xorV(s1, e1);
+        V c1 = Ops::orV(Ops::andV(w1, x1), Ops::andV(e1, s1));
+        V t1 = Ops::xorV(u1, c0);
+        V c2 = Ops::andV(u1, c0);
+        V t2 = Ops::xorV(c1, c2);
+        V t3 = Ops::andV(c1, c2);
+
+        // Count k matches when every plane has k's bit; t3 implies t2 = t1 = 0
+        V lo[4] = {Ops::andNot(t1, Ops::andNot(t0, Ops::set1(~0ULL))),
+                   Ops::andNot(t1, t0), Ops::andNot(t0, t1), Ops::andV(t1, t0)};
+        V hi[3] = {Ops::andNot(t3, Ops::andNot(t2, Ops::set1(~0ULL))), t2, t3};
+
+        V birth = Ops::set1(0), survival = Ops::set1(0);
+        for (int k = 0; k < 10; k++) {
+            V eq = Ops::andV(hi[k >> 2], lo[k & 3]);
+            birth = Ops::orV(birth, Ops::andV(eq, born[k]));
+            survival = Ops::orV(survival, Ops::andV(eq, kept[k]));
+        }
+        V c = Ops::load(centre + w);
+        Ops::store(out + w, Ops::orV(Ops::andV(c, survival), Ops::andNot(c, birth)));
+    }
+    return w;
+}
+
+} // namespace simd_kernels
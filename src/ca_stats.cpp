@@ -0,0 +1,122 @@
+#include "ca_stats.hpp"
+#include "bit_utils.hpp"
+#include <algorithm>
+
+namespace {
+
+template <bool StreamOrder>
+uint64_t cellWord(const uint64_t* words, ptrdiff_t w) {
+    return StreamOrder ? byteSwap64(words[w]) : words[w];
+}
+
+template <bool StreamOrder>
+void gatherWords(const uint64_t* words, size_t bytes, bool hasPrevious, bool atEnd, GenerationStats& part) {
+    if (bytes == 0) return;
+    uint64_t* histogram = part.bytes.histogram.data();
+    uint64_t previous = hasPrevious ? cellWord<StreamOrder>(words, -1) : 0;
+    uint64_t lag = 0;
+    uint64_t transitions = 0;
+
+    // Four count tables so that runs of equal bytes do not wait on one
+    // counter; flushed before any count could pass 32 bits
+    constexpr size_t BlockWords = size_t(1) << 26;
+    const size_t whole = bytes / 8;
+    uint32_t c[4 * 256] = {};
+    for (size_t block = 0; block < whole; block += BlockWords) {
+        const size_t end = std::min(whole, block + BlockWords);
+        for (size_t w = block; w < end; w++) {
+            const uint64_t x = cellWord<StreamOrder>(words, static_cast<ptrdiff_t>(w));
+            // Bit k of x ^ (x >> 1) compares cell k with the one before it;
+            // the top bit compares with the last cell of the previous word
+            transitions += popcount64(x ^ ((x >> 1) | (previous << 63)));
+            const uint32_t b0 = static_cast<uint32_t>(x >> 56), b1 = (x >> 48) & 0xFF;
+            const uint32_t b2 = (x >> 40) & 0xFF, b3 = (x >> 32) & 0xFF;
+            const uint32_t b4 = (x >> 24) & 0xFF, b5 = (x >> 16) & 0xFF;
+            const uint32_t b6 = (x >> 8) & 0xFF, b7 = x & 0xFF;
+            c[b0]++; c[256 + b1]++; c[512 + b2]++; c[768 + b3]++;
+            c[b4]++; c[256 + b5]++; c[512 + b6]++; c[768 + b7]++;
+            // Each odd byte times the sum of its neighbours in 16-bit lanes:
+            // b1 (b0 + b2) + b3 (b2 + b4) + b5 (b4 + b6) + b7 b6, the
+            // pair b7 b8 going to the next word
+            const uint64_t odd = x & 0x00FF00FF00FF00FFull;
+            const uint64_t even = (x >> 8) & 0x00FF00FF00FF00FFull;
+            const uint64_t around = even + (even << 16);
+            lag += (previous & 0xFF) * b0 + (odd >> 48) * (around >> 48) +
+                   ((odd >> 32) & 0xFFFF) * ((around >> 32) & 0xFFFF) +
+                   ((odd >> 16) & 0xFFFF) * ((around >> 16) & 0xFFFF) + (odd & 0xFFFF) * (around & 0xFFFF);
+            previous = x;
+        }
+        for (size_t b = 0; b < 256; b++) {
+            histogram[b] += uint64_t(c[b]) + c[256 + b] + c[512 + b] + c[768 + b];
+        }
+        std::fill(c, c + 4 * 256, 0u);
+    }
+
+    const size_t tail = bytes % 8;
+    if (tail != 0) {
+        const uint64_t x = cellWord<StreamOrder>(words, static_cast<ptrdiff_t>(whole));
+        const uint64_t mask = ~0ULL << (64 - 8 * tail);
+        transitions += popcount64((x ^ ((x >> 1) | (previous << 63))) & mask);
+        uint64_t before = previous & 0xFF;
+        for (int shift = 56; shift >= static_cast<int>(64 - 8 * tail); shift -= 8) {
+            const uint64_t b = (x >> shift) & 0xFF;
+            histogram[b]++;
+            lag += before * b;
+            before = b;
+        }
+    }
+
+    // With no previous word the top cell was compared with a 0 and the first
+    // byte multiplied by one
+    const uint64_t first = cellWord<StreamOrder>(words, 0);
+    if (!hasPrevious) {
+        transitions -= first >> 63;
+        part.bytes.first = static_cast<uint8_t>(first >> 56);
+    }
+    if (atEnd) {
+        const size_t last = bytes - 1;
+        part.bytes.last = static_cast<uint8_t>(cellWord<StreamOrder>(words, static_cast<ptrdiff_t>(last / 8)) >>
+                                               (56 - 8 * (last % 8)));
+    }
+    part.bytes.lagProducts += lag;
+    part.transitions += transitions;
+}
+
+} // namespace
+
+void GenerationStats::addPart(const GenerationStats& part) {
+    for (size_t i = 0; i < 256; i++) {
+        bytes.histogram[i] += part.bytes.histogram[i];
+    }
+    bytes.lagProducts += part.bytes.lagProducts;
+    bytes.first |= part.bytes.first;  // set by one part only
+    bytes.last |= part.bytes.last;
+    transitions += part.transitions;
+}
+
+void GenerationStats::finish() {
+    bytes.count = 0;
+    bytes.sum = 0;
+    bytes.sumSquares = 0;
+    for (uint64_t b = 0; b < 256; b++) {
+        bytes.count += bytes.histogram[b];
+        bytes.sum += bytes.histogram[b] * b;
+        bytes.sumSquares += bytes.histogram[b] * b * b;
+    }
+}
+
+void gatherStats(const uint64_t* words, size_t bytes, bool hasPrevious, bool atEnd, bool streamOrder,
+                 GenerationStats& part) {
+    if (streamOrder) {
+        gatherWords<true>(words, bytes, hasPrevious, atEnd, part);
+    } else {
+        gatherWords<false>(words, bytes, hasPrevious, atEnd, part);
+    }
+}
+
+GenerationStats gridStats(const CellWords& grid, size_t size, bool streamOrder) {
+    GenerationStats stats;
+    gatherStats(grid.data() + 1, size, false, true, streamOrder, stats);
+    stats.finish();
+    return stats;
+}
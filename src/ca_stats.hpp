@@ -0,0 +1,45 @@
+#ifndef CA_STATS_HPP
+#define CA_STATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "aligned_allocator.hpp"
+#include "byte_stats.hpp"
+
+// What a CA processor's update() gathers about the generations it computes.
+// The statistics are taken in the tile passes that write the generations,
+// while each tile is still in cache, instead of in a pass of their own.
+enum class CAStats {
+    None,   // nothing (the default)
+    Final,  // the generation each update() ends on
+    Every   // every generation, kept for generationStats(t)
+};
+
+// Statistics of one CA generation: exactly what ByteStats::add would give
+// over its processed bytes, plus the cell transitions. The popcount is
+// bytes.onesCount().
+struct GenerationStats {
+    ByteStats bytes;
+    uint64_t transitions = 0;  // adjacent cells that differ (the runs test's V_n - 1)
+
+    uint64_t ones() const { return bytes.onesCount(); }
+
+    // A generation is gathered in parts (tiles) added in any order; finish()
+    // then derives the count and sums from the histogram
+    void addPart(const GenerationStats& part);
+    void finish();
+};
+
+// Adds `bytes` bytes of cells from `words` to `part`: their histogram, lag-1
+// products and transitions, including the pair with the byte and cell just
+// before words[0] (read from words[-1]) when `hasPrevious`. Without a
+// previous word the first byte is recorded as the generation's first, and
+// with `atEnd` the last byte as its last. Words are in cell order (first
+// cell in the top bit), or byte-swapped with `streamOrder`.
+void gatherStats(const uint64_t* words, size_t bytes, bool hasPrevious, bool atEnd, bool streamOrder,
+                 GenerationStats& part);
+
+// Finished statistics of the first `size` bytes of a guarded grid
+GenerationStats gridStats(const CellWords& grid, size_t size, bool streamOrder);
+
+#endif // CA_STATS_HPP
@@ -0,0 +1,36 @@
+#ifndef CA_TRAJECTORY_HPP
+#define CA_TRAJECTORY_HPP
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Iteration sweeps from a single evolution. `ca` is any of the CA processors
+// (anything with update(int generations)), already initialized; it is
+// advanced to each checkpoint generation in ascending order and
+// onCheckpoint(generation) is called there, while the processor holds that
+// generation, so the callback can extract or test the snapshot. Checkpoints
+// {1, 3, 5, 10} cost 10 generations instead of 19 for separate runs, and
+// the CA keeps its cache tiling between checkpoints.
+//
+// Checkpoints may be given in any order; duplicates are visited once, and
+// generation 0 reports the initial state. Throws std::runtime_error for
+// negative checkpoints.
+template <typename Automaton, typename Callback>
+void runTrajectory(Automaton& ca, std::vector<int> checkpoints, Callback&& onCheckpoint) {
+    std::sort(checkpoints.begin(), checkpoints.end());
+    checkpoints.erase(std::unique(checkpoints.begin(), checkpoints.end()), checkpoints.end());
+    if (!checkpoints.empty() && checkpoints.front() < 0) {
+        throw std::runtime_error("Negative CA checkpoint: " + std::to_string(checkpoints.front()));
+    }
+
+    int generation = 0;
+    for (int checkpoint : checkpoints) {
+        ca.update(checkpoint - generation);
+        generation = checkpoint;
+        onCheckpoint(generation);
+    }
+}
+
+#endif // CA_TRAJECTORY_HPP
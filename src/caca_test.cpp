@@ -4,21 +4,10 @@
 #include <string>
 #include <fstream>
 #include "ca_analyzer.hpp"
+#include "ca_trajectory.hpp"
 #include "nist_sts.hpp"
 #include "stat_analyzer.hpp"
-
-// Helper function to load binary data
-std::vector<uint8_t> loadData(const std::string& filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file) {
-        throw std::runtime_error("Cannot open file: " + filename);
-    }
-    
-    return std::vector<uint8_t>(
-        (std::istreambuf_iterator<char>(file)), 
-        std::istreambuf_iterator<char>()
-    );
-}
+#include "mapped_file.hpp"
 
 // Helper function to save results to a simple CSV file
 void saveResults(const std::string& filename, 
@@ -59,9 +48,10 @@ int main(int argc, char** argv) {
         std::string inputFile = argv[1];
         std::string outputPrefix = (argc > 2) ? argv[2] : "caca_results";
         
-        // Load encrypted data
+        // Map encrypted data (read in place, no copy)
         std::cout << "Loading data from " << inputFile << "...\n";
-        auto encryptedData = loadData(inputFile);
+        MappedFile encryptedFile(inputFile);
+        ByteSpan encryptedData = encryptedFile.bytes();
         std::cout << "Loaded " << encryptedData.size() << " bytes\n";
         
         // Create NIST test suite
@@ -90,22 +80,19 @@ int main(int argc, char** argv) {
         // Define CA rules to test
         std::vector<int> rules = {30, 82, 110, 150};
         
-        // Run CA with different rules and iterations
+        // Run CA with different rules, testing each rule's single evolution
+        // at the checkpoint iterations
         for (int rule : rules) {
-            for (int iterations : {1, 3, 5, 10}) {
+            CellularAutomataProcessor ca(encryptedData.size(), rule);
+            ca.setStats(CAStats::Final);  // byte statistics from the update passes
+            ca.initializeFromCiphertext(encryptedData);
+            
+            runTrajectory(ca, {1, 3, 5, 10}, [&](int iterations) {
                 std::cout << "\nApplying CA Rule " << rule << " with " << iterations << " iterations...\n";
                 
-                // Initialize CA processor
-                CellularAutomataProcessor ca(encryptedData.size(), rule);
-                ca.initializeFromCiphertext(encryptedData);
-                
-                // Apply CA iterations
-                for (int i = 0; i < iterations; i++) {
-                    ca.updateCA_SIMD();
-                }
-                
                 // Extract processed data
                 auto processedData = ca.extractProcessedData();
+                const ByteStats stats = ca.stats().bytes;
                 
                 // Run NIST tests on processed data
                 auto processedResults = nistTests.runTests(processedData);
@@ -117,9 +104,9 @@ int main(int argc, char** argv) {
                 }
                 
                 // Add statistics
-                processedPValues["IndexOfCoincidence"] = StatAnalyzer::indexOfCoincidence(processedData);
-                processedPValues["ChiSquare"] = StatAnalyzer::chiSquare(processedData);
-                processedPValues["SerialCorrelation"] = StatAnalyzer::serialCorrelation(processedData);
+                processedPValues["IndexOfCoincidence"] = stats.indexOfCoincidence();
+                processedPValues["ChiSquare"] = stats.chiSquare();
+                processedPValues["SerialCorrelation"] = stats.serialCorrelation();
                 
                 // Add to results
                 std::string datasetName = "Rule" + std::to_string(rule) + "_Iter" + std::to_string(iterations);
@@ -127,9 +114,9 @@ int main(int argc, char** argv) {
                 
                 // Display key statistics
                 std::cout << "Post-CA statistics:\n";
-                std::cout << "Index of Coincidence: " << StatAnalyzer::indexOfCoincidence(processedData) << "\n";
-                std::cout << "Chi-Square: " << StatAnalyzer::chiSquare(processedData) << "\n";
-                std::cout << "Serial Correlation: " << StatAnalyzer::serialCorrelation(processedData) << "\n";
+                std::cout << "Index of Coincidence: " << stats.indexOfCoincidence() << "\n";
+                std::cout << "Chi-Square: " << stats.chiSquare() << "\n";
+                std::cout << "Serial Correlation: " << stats.serialCorrelation() << "\n";
                 
                 // Save processed data
                 std::string outputFile = outputPrefix + "_rule" + std::to_string(rule) + 
@@ -137,7 +124,7 @@ int main(int argc, char** argv) {
                 std::ofstream outFile(outputFile, std::ios::binary);
                 outFile.write(reinterpret_cast<const char*>(processedData.data()), processedData.size());
                 std::cout << "Saved processed data to " << outputFile << "\n";
-            }
+            });
         }
         
         // Save results to CSV
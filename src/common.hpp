@@ -45,12 +45,23 @@ struct TestResults {
     size_t data_size = 0;
 };
 
+class BitSequence;
+class PatternHistogram;
+
 // Base class for all statistical tests
 class StatisticalTest {
 public:
     virtual ~StatisticalTest() = default;
     virtual TestResult execute(const class BitSequence& data) = 0;
     virtual std::string getName() const = 0;
+
+    // Order of the cyclic pattern histogram the test is computed from, or 0
+    // if it reads none. A suite counts the highest order its tests need once
+    // per sequence and passes it to executeWith; lower orders are marginals.
+    virtual size_t patternOrder() const { return 0; }
+    virtual TestResult executeWith(const BitSequence& data, const PatternHistogram&) {
+        return execute(data);
+    }
     
 protected:
     bool isSuccess(double p_value) const {
@@ -0,0 +1,134 @@
+// cpu_features.cpp
+#include "cpu_features.hpp"
+#include "simd_kernels.hpp"
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#define CACA_X86 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define CACA_X86 1
+#endif
+
+namespace {
+
+#ifdef CACA_X86
+struct CpuidRegs {
+    uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+};
+
+CpuidRegs cpuid(uint32_t leaf, uint32_t subleaf) {
+    CpuidRegs r;
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuidex(regs, static_cast<int>(leaf), static_cast<int>(subleaf));
+    r.eax = static_cast<uint32_t>(regs[0]);
+    r.ebx = static_cast<uint32_t>(regs[1]);
+    r.ecx = static_cast<uint32_t>(regs[2]);
+    r.edx = static_cast<uint32_t>(regs[3]);
+#else
+    __cpuid_count(leaf, subleaf, r.eax, r.ebx, r.ecx, r.edx);
+#endif
+    return r;
+}
+
+// Register state the OS saves on context switch (XCR0)
+uint64_t enabledStateMask() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+#endif
+}
+
+SimdLevel cpuSimdLevel() {
+    const uint32_t maxLeaf = cpuid(0, 0).eax;
+    const CpuidRegs leaf1 = cpuid(1, 0);
+    if (!(leaf1.edx & (1u << 26))) return SimdLevel::Scalar;  // SSE2
+
+    // AVX needs the OS to save the YMM state (XCR0 bits 1-2), AVX-512 the
+    // opmask and ZMM state as well (bits 5-7)
+    const bool osxsave = (leaf1.ecx & (1u << 27)) != 0;
+    const bool popcnt = (leaf1.ecx & (1u << 23)) != 0;
+    const uint64_t xcr0 = osxsave ? enabledStateMask() : 0;
+    if (maxLeaf < 7 || (xcr0 & 0x6) != 0x6 || !popcnt) return SimdLevel::SSE2;
+
+    const CpuidRegs leaf7 = cpuid(7, 0);
+    const bool avx2 = (leaf7.ebx & (1u << 5)) != 0;
+    const bool avx512f = (leaf7.ebx & (1u << 16)) != 0;
+    if (!avx2) return SimdLevel::SSE2;
+    if (!avx512f || (xcr0 & 0xE6) != 0xE6) return SimdLevel::AVX2;
+    return SimdLevel::AVX512;
+}
+#else
+SimdLevel cpuSimdLevel() {
+    return SimdLevel::Scalar;
+}
+#endif
+
+bool built(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return true;
+        case SimdLevel::SSE2: return simd_kernels::builtSse2();
+        case SimdLevel::AVX2: return simd_kernels::builtAvx2();
+        case SimdLevel::AVX512: return simd_kernels::builtAvx512();
+    }
+    return false;
+}
+
+// Highest level at or below `level` whose kernels were compiled in
+SimdLevel builtLevel(SimdLevel level) {
+    while (!built(level)) {
+        level = static_cast<SimdLevel>(static_cast<int>(level) - 1);
+    }
+    return level;
+}
+
+std::atomic<int>& activeLevel() {
+    static std::atomic<int> level{static_cast<int>(detectSimdLevel())};
+    return level;
+}
+
+} // namespace
+
+SimdLevel detectSimdLevel() {
+    static const SimdLevel level = builtLevel(cpuSimdLevel());
+    return level;
+}
+
+SimdLevel simdLevel() {
+    return static_cast<SimdLevel>(activeLevel().load(std::memory_order_relaxed));
+}
+
+void setSimdLevel(SimdLevel level) {
+    if (level > detectSimdLevel()) {
+        throw std::runtime_error(std::string("SIMD level ") + simdLevelName(level) +
+                                 " is not available (best: " + simdLevelName(detectSimdLevel()) + ")");
+    }
+    activeLevel().store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+SimdLevel parseSimdLevel(const std::string& name) {
+    if (name == "auto") return detectSimdLevel();
+    if (name == "scalar") return SimdLevel::Scalar;
+    if (name == "sse2") return SimdLevel::SSE2;
+    if (name == "avx2") return SimdLevel::AVX2;
+    if (name == "avx512") return SimdLevel::AVX512;
+    throw std::runtime_error("Unknown SIMD level: " + name + " (use scalar, sse2, avx2, avx512 or auto)");
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::SSE2: return "sse2";
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
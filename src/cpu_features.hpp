@@ -0,0 +1,29 @@
+// cpu_features.hpp
+#pragma once
+#include <string>
+
+// Instruction sets the SIMD kernels are built for, in increasing order. The
+// kernels live in per-ISA translation units compiled with their own flags
+// (see CMakeLists.txt), so one binary carries all of them and the best one
+// the CPU supports is chosen at run time.
+enum class SimdLevel {
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+// Best level this CPU and OS support (cpuid plus the OS register-state
+// check), limited to the kernels present in this build
+SimdLevel detectSimdLevel();
+
+// Level the kernels dispatch on: detectSimdLevel() unless overridden
+SimdLevel simdLevel();
+
+// Override for testing or benchmarking; throws std::runtime_error if the
+// level is above detectSimdLevel()
+void setSimdLevel(SimdLevel level);
+
+// "scalar", "sse2", "avx2", "avx512", or "auto" for detectSimdLevel()
+SimdLevel parseSimdLevel(const std::string& name);
+const char* simdLevelName(SimdLevel level);
@@ -0,0 +1,308 @@
+// denoise_benchmark.cpp
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include "image_io.hpp"
+#include "image_metrics.hpp"
+#include "ca_denoiser.hpp"
+#include "byte_filter.hpp"
+#include "cpu_features.hpp"
+#include "worker_pool.hpp"
+
+// Salt-and-pepper denoising benchmark: the clean image is corrupted at each
+// noise density, every engine is run on every noisy copy, and the quality of
+// the result is measured at each checkpoint iteration. As in
+// simple_ca_test.cpp, each (noise, engine) pair is one evolution with the
+// results taken at the checkpoints; the pairs run in parallel.
+
+struct BenchmarkOptions {
+    std::string inputFile;
+    size_t rawWidth = 0;
+    std::vector<double> densities{0.1, 0.3, 0.5, 0.7, 0.9};
+    std::vector<std::string> engines{"ca", "median3", "median5"};
+    std::vector<int> checkpoints{1, 3, 5, 10};
+    unsigned threads = 0;        // 0 = every core
+    uint64_t seed = 1;
+    std::string outputPrefix = "denoise";
+    bool saveImages = false;
+};
+
+// One row of the results table
+struct BenchmarkRow {
+    double density = 0;
+    std::string engine;
+    int iterations = 0;
+    double milliseconds = 0;    // cumulative, for this engine at this density
+    ImageQuality quality;
+};
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find(',', start);
+        if (end == std::string::npos) end = text.size();
+        if (end > start) items.push_back(text.substr(start, end - start));
+        start = end + 1;
+    }
+    return items;
+}
+
+// An engine run on each channel plane of an image, advanced in step:
+// "ca" is the adaptive median CA (ca_denoiser.hpp), anything else a
+// ByteFilter spec run along each row of the plane (byte_filter.hpp)
+class DenoiseRun {
+public:
+    DenoiseRun(const std::string& engine, const Image& noisy) : image(noisy) {
+        for (size_t c = 0; c < image.channels; c++) {
+            const std::vector<uint8_t> plane = image.plane(c);
+            if (engine == "ca") {
+                denoisers.emplace_back(image.width, plane.size());
+                denoisers.back().initializeFromCiphertext(plane);
+            } else {
+                filters.emplace_back(plane.size(), ByteFilter::parse(engine), image.width);
+                filters.back().initializeFromCiphertext(plane);
+            }
+        }
+    }
+
+    void advance(int generations) {
+        for (auto& denoiser : denoisers) denoiser.update(generations);
+        for (auto& filter : filters) filter.update(generations);
+    }
+
+    const Image& result() {
+        for (size_t c = 0; c < image.channels; c++) {
+            image.setPlane(c, denoisers.empty() ? filters[c].extractProcessedData()
+                                                : denoisers[c].extractProcessedData());
+        }
+        return image;
+    }
+
+private:
+    Image image;
+    std::vector<CADenoiser> denoisers;
+    std::vector<ByteFilterProcessor> filters;
+};
+
+std::string densityLabel(double density) {
+    std::ostringstream label;
+    label << "n" << std::lround(density * 100);
+    return label.str();
+}
+
+std::string imageExtension(const Image& image) {
+    return image.channels == 3 ? ".ppm" : ".pgm";
+}
+
+std::vector<BenchmarkRow> runBenchmark(const Image& clean, const BenchmarkOptions& options) {
+    const size_t densityCount = options.densities.size();
+    const size_t engineCount = options.engines.size();
+
+    // The noisy copies are shared read-only by every engine
+    std::vector<Image> noisy(densityCount, clean);
+    for (size_t d = 0; d < densityCount; d++) {
+        addSaltAndPepper(noisy[d], options.densities[d], options.seed + d);
+    }
+
+    // Per density: the noisy image itself (iteration 0), then each engine's
+    // checkpoints
+    const size_t rowsPerEngine = options.checkpoints.size();
+    const size_t rowsPerDensity = 1 + engineCount * rowsPerEngine;
+    std::vector<BenchmarkRow> rows(densityCount * rowsPerDensity);
+
+    WorkerPool pool(options.threads);
+    runJobs(pool, densityCount * (engineCount + 1), [&](size_t job) {
+        const size_t d = job / (engineCount + 1);
+        const size_t e = job % (engineCount + 1);
+        const double density = options.densities[d];
+
+        if (e == 0) {
+            BenchmarkRow& row = rows[d * rowsPerDensity];
+            row.density = density;
+            row.engine = "noisy";
+            row.quality = measureQuality(clean, noisy[d]);
+            if (options.saveImages) {
+                saveImage(options.outputPrefix + "_" + densityLabel(density) + imageExtension(clean), noisy[d]);
+            }
+            return;
+        }
+
+        const std::string& engine = options.engines[e - 1];
+        DenoiseRun run(engine, noisy[d]);
+        int iterations = 0;
+        double milliseconds = 0;
+        for (size_t k = 0; k < rowsPerEngine; k++) {
+            // Advance to the next checkpoint
+            const int checkpoint = options.checkpoints[k];
+            auto startTime = std::chrono::high_resolution_clock::now();
+            run.advance(checkpoint - iterations);
+            auto endTime = std::chrono::high_resolution_clock::now();
+            milliseconds += std::chrono::duration<double, std::milli>(endTime - startTime).count();
+            iterations = checkpoint;
+
+            const Image& restored = run.result();
+            BenchmarkRow& row = rows[d * rowsPerDensity + 1 + (e - 1) * rowsPerEngine + k];
+            row.density = density;
+            row.engine = engine;
+            row.iterations = iterations;
+            row.milliseconds = milliseconds;
+            row.quality = measureQuality(clean, restored);
+            if (options.saveImages) {
+                saveImage(options.outputPrefix + "_" + densityLabel(density) + "_" + engine + "_iter" +
+                          std::to_string(iterations) + imageExtension(clean), restored);
+            }
+        }
+    });
+    return rows;
+}
+
+void printRows(std::ostream& out, const std::vector<BenchmarkRow>& rows) {
+    out << std::left << std::setw(7) << "Noise" << std::setw(11) << "Engine" << std::right
+        << std::setw(6) << "Iter" << std::setw(11) << "Time(ms)" << std::setw(12) << "MSE"
+        << std::setw(10) << "PSNR(dB)" << std::setw(9) << "SSIM" << "\n";
+    out << std::fixed;
+    for (const BenchmarkRow& row : rows) {
+        out << std::left << std::setw(7) << std::setprecision(2) << row.density
+            << std::setw(11) << row.engine << std::right << std::setw(6) << row.iterations
+            << std::setw(11) << std::setprecision(1) << row.milliseconds
+            << std::setw(12) << std::setprecision(2) << row.quality.mse
+            << std::setw(10) << std::setprecision(2) << row.quality.psnr
+            << std::setw(9) << std::setprecision(4) << row.quality.ssim << "\n";
+    }
+}
+
+void saveRows(const std::string& filename, const std::vector<BenchmarkRow>& rows) {
+    std::ofstream file(filename);
+    if (!file) {
+        throw std::runtime_error("Cannot open output file: " + filename);
+    }
+    file << "noise,engine,iterations,time_ms,mse,psnr_db,ssim\n";
+    file << std::setprecision(10);
+    for (const BenchmarkRow& row : rows) {
+        file << row.density << "," << row.engine << "," << row.iterations << "," << row.milliseconds << ","
+             << row.quality.mse << "," << row.quality.psnr << "," << row.quality.ssim << "\n";
+    }
+}
+
+void printUsage(const char* progName) {
+    std::cout << "Usage: " << progName << " -f <image> [options]\n\n"
+              << "Options:\n"
+              << "  -f, --file <path>        Clean image: binary PGM/PPM, or raw grey bytes with -w\n"
+              << "  -w, --width <n>          Row width of a raw image\n"
+              << "  -n, --noise <d1,d2>      Salt-and-pepper densities 0-1 (default: 0.1,0.3,0.5,0.7,0.9)\n"
+              << "  -r, --engines <e1,e2>    ca (adaptive median CA) and byte filters such as median5\n"
+              << "                           or open3, run along the rows (default: ca,median3,median5)\n"
+              << "  -i, --iterations <i1,..> Checkpoint iterations (default: 1,3,5,10)\n"
+              << "  -t, --threads <n>        Worker threads, 0 = every core (default: 0)\n"
+              << "  -S, --seed <n>           Noise seed (default: 1)\n"
+              << "  -o, --output <prefix>    Output prefix (default: denoise)\n"
+              << "      --save               Also write the noisy and restored images\n"
+              << "      --simd <level>       Kernel level: auto, scalar, sse2, avx2, avx512\n"
+              << "  -h, --help               Show this help message\n\n"
+              << "Writes the results table to <prefix>_results.csv.\n";
+}
+
+BenchmarkOptions parseArgs(int argc, char** argv) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            std::exit(0);
+        } else if (arg == "-f" || arg == "--file") {
+            options.inputFile = value();
+        } else if (arg == "-w" || arg == "--width") {
+            options.rawWidth = std::stoul(value());
+        } else if (arg == "-n" || arg == "--noise") {
+            options.densities.clear();
+            for (const std::string& item : splitList(value())) {
+                const double density = std::stod(item);
+                if (density < 0 || density > 1) {
+                    throw std::runtime_error("Noise density must be between 0 and 1: " + item);
+                }
+                options.densities.push_back(density);
+            }
+        } else if (arg == "-r" || arg == "--engines") {
+            options.engines = splitList(value());
+            for (const std::string& engine : options.engines) {
+                if (engine != "ca") ByteFilter::parse(engine);  // throws on an unknown engine
+            }
+        } else if (arg == "-i" || arg == "--iterations") {
+            options.checkpoints.clear();
+            for (const std::string& item : splitList(value())) {
+                const int checkpoint = std::stoi(item);
+                if (checkpoint < 1) {
+                    throw std::runtime_error("Checkpoint iterations must be positive: " + item);
+                }
+                options.checkpoints.push_back(checkpoint);
+            }
+            std::sort(options.checkpoints.begin(), options.checkpoints.end());
+            options.checkpoints.erase(std::unique(options.checkpoints.begin(), options.checkpoints.end()),
+                                      options.checkpoints.end());
+        } else if (arg == "-t" || arg == "--threads") {
+            options.threads = static_cast<unsigned>(std::stoul(value()));
+        } else if (arg == "-S" || arg == "--seed") {
+            options.seed = std::stoull(value());
+        } else if (arg == "-o" || arg == "--output") {
+            options.outputPrefix = value();
+        } else if (arg == "--save") {
+            options.saveImages = true;
+        } else if (arg == "--simd") {
+            setSimdLevel(parseSimdLevel(value()));
+        } else {
+            throw std::runtime_error("Unknown option: " + arg);
+        }
+    }
+    if (options.inputFile.empty()) {
+        printUsage(argv[0]);
+        throw std::runtime_error("No input image given");
+    }
+    if (options.densities.empty() || options.engines.empty() || options.checkpoints.empty()) {
+        throw std::runtime_error("Noise densities, engines and iterations must not be empty");
+    }
+    return options;
+}
+
+int main(int argc, char** argv) {
+    try {
+        const BenchmarkOptions options = parseArgs(argc, argv);
+
+        std::cout << "Loading image from " << options.inputFile << "...\n";
+        const Image clean = loadImage(options.inputFile, options.rawWidth);
+        std::cout << "Loaded " << clean.width << "x" << clean.height
+                  << (clean.channels == 3 ? " RGB" : " grey") << " image\n";
+        std::cout << "SIMD level: " << simdLevelName(simdLevel()) << "\n\n";
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        const std::vector<BenchmarkRow> rows = runBenchmark(clean, options);
+        auto endTime = std::chrono::high_resolution_clock::now();
+
+        printRows(std::cout, rows);
+        std::cout << "\nSweep time: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count() << " ms\n";
+
+        const std::string resultsFile = options.outputPrefix + "_results.csv";
+        saveRows(resultsFile, rows);
+        std::cout << "Saved results table to " << resultsFile << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
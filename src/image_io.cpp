@@ -0,0 +1,113 @@
+#include "image_io.hpp"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+// Next header field of a PNM file: skips whitespace and '#' comments
+size_t readField(const std::vector<uint8_t>& data, size_t& pos, const std::string& filename) {
+    while (pos < data.size()) {
+        if (data[pos] == '#') {
+            while (pos < data.size() && data[pos] != '\n') pos++;
+        } else if (std::isspace(data[pos])) {
+            pos++;
+        } else {
+            break;
+        }
+    }
+    size_t value = 0;
+    size_t digits = 0;
+    for (; pos < data.size() && std::isdigit(data[pos]) && digits < 9; pos++, digits++) {
+        value = 10 * value + (data[pos] - '0');
+    }
+    if (digits == 0) {
+        throw std::runtime_error("Malformed PNM header: " + filename);
+    }
+    return value;
+}
+
+} // namespace
+
+std::vector<uint8_t> Image::plane(size_t c) const {
+    std::vector<uint8_t> values(width * height);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = pixels[i * channels + c];
+    }
+    return values;
+}
+
+void Image::setPlane(size_t c, const std::vector<uint8_t>& values) {
+    for (size_t i = 0; i < width * height; i++) {
+        pixels[i * channels + c] = values[i];
+    }
+}
+
+Image loadImage(const std::string& filename, size_t rawWidth) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    Image image;
+    if (data.size() >= 2 && data[0] == 'P' && (data[1] == '5' || data[1] == '6')) {
+        size_t pos = 2;
+        image.channels = data[1] == '5' ? 1 : 3;
+        image.width = readField(data, pos, filename);
+        image.height = readField(data, pos, filename);
+        const size_t maxval = readField(data, pos, filename);
+        if (maxval == 0 || maxval > 255) {
+            throw std::runtime_error("Only 8-bit PNM images are supported: " + filename);
+        }
+        pos++;  // the single whitespace byte before the raster
+        const size_t bytes = image.width * image.height * image.channels;
+        if (image.width == 0 || image.height == 0 || pos > data.size() || data.size() - pos < bytes) {
+            throw std::runtime_error("Truncated PNM image: " + filename);
+        }
+        image.pixels.assign(data.begin() + pos, data.begin() + pos + bytes);
+        if (maxval < 255) {
+            for (uint8_t& v : image.pixels) {
+                v = static_cast<uint8_t>((std::min<size_t>(v, maxval) * 255 + maxval / 2) / maxval);
+            }
+        }
+        return image;
+    }
+
+    if (rawWidth == 0) {
+        throw std::runtime_error("Not a PGM/PPM image (give a width for raw input): " + filename);
+    }
+    image.width = rawWidth;
+    image.height = data.size() / rawWidth;
+    if (image.height == 0) {
+        throw std::runtime_error("Raw image smaller than one row: " + filename);
+    }
+    data.resize(image.width * image.height);
+    image.pixels = std::move(data);
+    return image;
+}
+
+void saveImage(const std::string& filename, const Image& image) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open output file: " + filename);
+    }
+    file << (image.channels == 3 ? "P6" : "P5") << "\n" << image.width << " " << image.height << "\n255\n";
+    file.write(reinterpret_cast<const char*>(image.pixels.data()), image.pixels.size());
+}
+
+void addSaltAndPepper(Image& image, double density, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    // One 64-bit draw per sample: the low 63 bits against the density, the
+    // top bit for salt or pepper
+    const uint64_t threshold = static_cast<uint64_t>(std::clamp(density, 0.0, 1.0) * 9223372036854775808.0);
+    for (uint8_t& v : image.pixels) {
+        const uint64_t draw = rng();
+        if ((draw & 0x7FFFFFFFFFFFFFFFull) < threshold) {
+            v = (draw >> 63) ? 255 : 0;
+        }
+    }
+}
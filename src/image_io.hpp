@@ -0,0 +1,33 @@
+// image_io.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 8-bit image with interleaved channels (1 = grey, 3 = RGB), row by row
+struct Image {
+    size_t width = 0;
+    size_t height = 0;
+    size_t channels = 1;
+    std::vector<uint8_t> pixels;
+
+    size_t size() const { return pixels.size(); }
+
+    // Channel c as a width x height grey plane, and back
+    std::vector<uint8_t> plane(size_t c) const;
+    void setPlane(size_t c, const std::vector<uint8_t>& values);
+};
+
+// Binary PGM (P5) or PPM (P6) with maxval up to 255; any other file is raw
+// grey bytes in rows of `rawWidth` (0 = no raw input allowed), with a final
+// partial row dropped. Throws std::runtime_error on unreadable or malformed
+// files.
+Image loadImage(const std::string& filename, size_t rawWidth = 0);
+
+// P5 for grey images, P6 for RGB
+void saveImage(const std::string& filename, const Image& image);
+
+// Salt-and-pepper noise: each sample independently becomes 0 or 255 (even
+// odds) with probability `density`. The same seed gives the same noise.
+void addSaltAndPepper(Image& image, double density, uint64_t seed);
@@ -0,0 +1,116 @@
+#include "image_metrics.hpp"
+#include "simd_kernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+constexpr size_t Window = 8;
+
+// SSIM of one window from its sums (x, y, x^2, y^2, xy) over n pixels,
+// with the means and variances scaled by n^2 to stay in integers
+double windowSsim(const uint64_t (&s)[5], int64_t n) {
+    const double c1 = (0.01 * 255) * (0.01 * 255) * n * n;
+    const double c2 = (0.03 * 255) * (0.03 * 255) * n * n;
+    const int64_t sx = static_cast<int64_t>(s[0]), sy = static_cast<int64_t>(s[1]);
+    const int64_t varX = n * static_cast<int64_t>(s[2]) - sx * sx;
+    const int64_t varY = n * static_cast<int64_t>(s[3]) - sy * sy;
+    const int64_t covXY = n * static_cast<int64_t>(s[4]) - sx * sy;
+    return ((2.0 * sx * sy + c1) * (2.0 * covXY + c2)) /
+           ((static_cast<double>(sx * sx + sy * sy) + c1) * (static_cast<double>(varX + varY) + c2));
+}
+
+} // namespace
+
+uint64_t squaredErrorSum(const uint8_t* a, const uint8_t* b, size_t size) {
+    using namespace simd_kernels;
+    uint64_t sum = 0;
+    size_t i = 0;
+    const SimdLevel level = simdLevel();
+    if (level >= SimdLevel::AVX2) {
+        i = squaredErrorAvx2(a, b, 0, size, sum);
+    } else if (level >= SimdLevel::SSE2) {
+        i = squaredErrorSse2(a, b, 0, size, sum);
+    }
+    for (; i < size; i++) {
+        const int d = a[i] - b[i];
+        sum += static_cast<uint64_t>(d * d);
+    }
+    return sum;
+}
+
+// Column sums of the window's rows are slid down the image a row at a time
+// by the kernels, then each row of windows is summed along them
+double structuralSimilarity(const uint8_t* x, const uint8_t* y, size_t width, size_t height) {
+    using namespace simd_kernels;
+    if (width == 0 || height == 0) {
+        throw std::runtime_error("SSIM of an empty image");
+    }
+    const size_t kw = std::min(Window, width);
+    const size_t kh = std::min(Window, height);
+    const int64_t n = static_cast<int64_t>(kw * kh);
+    const SimdLevel level = simdLevel();
+
+    std::vector<uint32_t> moments(5 * width, 0);
+    const std::vector<uint8_t> blank(width, 0);
+    double total = 0;
+    for (size_t row = 0; row < height; row++) {
+        const uint8_t* xIn = x + row * width;
+        const uint8_t* yIn = y + row * width;
+        const uint8_t* xOut = row >= kh ? x + (row - kh) * width : blank.data();
+        const uint8_t* yOut = row >= kh ? y + (row - kh) * width : blank.data();
+
+        size_t i = 0;
+        if (level >= SimdLevel::AVX2) {
+            i = slideMomentsAvx2(xIn, yIn, xOut, yOut, moments.data(), width, 0, width);
+        } else if (level >= SimdLevel::SSE2) {
+            i = slideMomentsSse2(xIn, yIn, xOut, yOut, moments.data(), width, 0, width);
+        }
+        for (; i < width; i++) {
+            moments[i] += xIn[i] - xOut[i];
+            moments[width + i] += yIn[i] - yOut[i];
+            moments[2 * width + i] += xIn[i] * xIn[i] - xOut[i] * xOut[i];
+            moments[3 * width + i] += yIn[i] * yIn[i] - yOut[i] * yOut[i];
+            moments[4 * width + i] += xIn[i] * yIn[i] - xOut[i] * yOut[i];
+        }
+        if (row + 1 < kh) continue;
+
+        uint64_t sums[5] = {};
+        for (size_t col = 0; col < width; col++) {
+            for (size_t m = 0; m < 5; m++) {
+                sums[m] += moments[m * width + col];
+                if (col >= kw) sums[m] -= moments[m * width + col - kw];
+            }
+            if (col + 1 >= kw) total += windowSsim(sums, n);
+        }
+    }
+    return total / static_cast<double>((width - kw + 1) * (height - kh + 1));
+}
+
+ImageQuality measureQuality(const Image& reference, const Image& test) {
+    if (reference.width != test.width || reference.height != test.height ||
+        reference.channels != test.channels || reference.size() != test.size()) {
+        throw std::runtime_error("Images to compare differ in size");
+    }
+    ImageQuality quality;
+    if (reference.size() == 0) return quality;
+
+    const uint64_t squared = squaredErrorSum(reference.pixels.data(), test.pixels.data(), reference.size());
+    quality.mse = static_cast<double>(squared) / static_cast<double>(reference.size());
+    quality.psnr = squared == 0 ? std::numeric_limits<double>::infinity()
+                                : 10.0 * std::log10(255.0 * 255.0 / quality.mse);
+
+    if (reference.channels == 1) {
+        quality.ssim = structuralSimilarity(reference.pixels.data(), test.pixels.data(),
+                                            reference.width, reference.height);
+    } else {
+        for (size_t c = 0; c < reference.channels; c++) {
+            const std::vector<uint8_t> x = reference.plane(c), y = test.plane(c);
+            quality.ssim += structuralSimilarity(x.data(), y.data(), reference.width, reference.height);
+        }
+        quality.ssim /= static_cast<double>(reference.channels);
+    }
+    return quality;
+}
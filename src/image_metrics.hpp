@@ -0,0 +1,26 @@
+// image_metrics.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "image_io.hpp"
+
+// Full-reference quality of a restored image against the clean original.
+// The sums run on the SIMD kernels of metric_kernels.hpp (SSE2 or AVX2,
+// chosen at run time) and are exact integers, so every level gives the same
+// figures. Throws std::runtime_error if the images differ in shape.
+struct ImageQuality {
+    double mse = 0;    // mean squared error over every sample
+    double psnr = 0;   // 10 log10(255^2 / mse) dB; infinity for identical images
+    double ssim = 0;   // mean SSIM over every 8x8 window and channel
+};
+
+ImageQuality measureQuality(const Image& reference, const Image& test);
+
+// Sum of squared differences of two byte buffers of `size` bytes
+uint64_t squaredErrorSum(const uint8_t* a, const uint8_t* b, size_t size);
+
+// Mean SSIM (Wang et al., 2004) of two grey planes over all 8x8 windows,
+// stride 1, with uniform weights and the usual C1 = (0.01 * 255)^2 and
+// C2 = (0.03 * 255)^2. Planes smaller than 8x8 are one window of their
+// own size.
+double structuralSimilarity(const uint8_t* x, const uint8_t* y, size_t width, size_t height);
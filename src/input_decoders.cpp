@@ -0,0 +1,207 @@
+// input_decoders.cpp
+#include "input_decoders.hpp"
+#include "simd_kernels.hpp"
+#include <stdexcept>
+#include <cstring>
+
+namespace {
+
+// Scalar lookup: symbol value, or one of the two markers below
+constexpr uint8_t SKIP = 0xFE;
+constexpr uint8_t BAD = 0xFF;
+
+struct DecodeTables {
+    uint8_t bits[256];
+    uint8_t hex[256];
+    uint8_t base64[256];
+
+    DecodeTables() {
+        std::memset(bits, BAD, sizeof(bits));
+        std::memset(hex, BAD, sizeof(hex));
+        std::memset(base64, BAD, sizeof(base64));
+        for (unsigned char c : {' ', '\t', '\n', '\r', '\v', '\f'}) {
+            bits[c] = hex[c] = base64[c] = SKIP;
+        }
+        bits['0'] = 0;
+        bits['1'] = 1;
+        for (int i = 0; i < 10; i++) hex['0' + i] = static_cast<uint8_t>(i);
+        for (int i = 0; i < 6; i++) {
+            hex['a' + i] = static_cast<uint8_t>(10 + i);
+            hex['A' + i] = static_cast<uint8_t>(10 + i);
+        }
+        const char* alphabet =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int i = 0; i < 64; i++) {
+            base64[static_cast<uint8_t>(alphabet[i])] = static_cast<uint8_t>(i);
+        }
+    }
+};
+
+const DecodeTables& tables() {
+    static const DecodeTables t;
+    return t;
+}
+
+[[noreturn]] void badCharacter(const char* format, size_t offset) {
+    throw std::runtime_error(std::string("Invalid ") + format +
+                             " character at offset " + std::to_string(offset));
+}
+
+
+} // namespace
+
+InputFormat InputDecoder::parseFormat(const std::string& name) {
+    if (name == "binary" || name == "bin") return InputFormat::Binary;
+    if (name == "ascii" || name == "bits") return InputFormat::AsciiBits;
+    if (name == "hex") return InputFormat::Hex;
+    if (name == "base64" || name == "b64") return InputFormat::Base64;
+    throw std::runtime_error("Unknown input format: " + name);
+}
+
+std::vector<uint8_t> InputDecoder::decodeAsciiBits(const ByteSpan& text, size_t& bitCount) {
+    const uint8_t* lut = tables().bits;
+    const uint8_t* in = text.data();
+    const size_t n = text.size();
+    const SimdLevel level = simdLevel();
+
+    std::vector<uint8_t> out(n / 8 + 1);
+    size_t bytes = 0;
+    unsigned acc = 0, pending = 0;
+
+    size_t i = 0;
+    while (i < n) {
+        if (pending == 0) {
+            // 32-character blocks, then a 16-character one up to the next
+            // whitespace or the end
+            if (level >= SimdLevel::AVX2) i = simd_kernels::asciiBitsAvx2(in, out.data(), i, n, bytes);
+            if (level >= SimdLevel::SSE2) i = simd_kernels::asciiBitsSse2(in, out.data(), i, n, bytes);
+            if (i == n) break;
+        }
+        uint8_t v = lut[in[i]];
+        if (v == BAD) badCharacter("ASCII bit", i);
+        i++;
+        if (v == SKIP) continue;
+        acc = (acc << 1) | v;
+        if (++pending == 8) {
+            out[bytes++] = static_cast<uint8_t>(acc);
+            acc = 0;
+            pending = 0;
+        }
+    }
+
+    bitCount = bytes * 8 + pending;
+    if (pending) out[bytes++] = static_cast<uint8_t>(acc << (8 - pending));
+    out.resize(bytes);
+    return out;
+}
+
+std::vector<uint8_t> InputDecoder::decodeHex(const ByteSpan& text) {
+    const uint8_t* lut = tables().hex;
+    const uint8_t* in = text.data();
+    const size_t n = text.size();
+    const SimdLevel level = simdLevel();
+
+    std::vector<uint8_t> out(n / 2 + 1);
+    size_t bytes = 0;
+    unsigned high = 0;
+    bool haveHigh = false;
+
+    size_t i = 0;
+    while (i < n) {
+        if (!haveHigh) {
+            if (level >= SimdLevel::AVX2) i = simd_kernels::hexAvx2(in, out.data(), i, n, bytes);
+            if (level >= SimdLevel::SSE2) i = simd_kernels::hexSse2(in, out.data(), i, n, bytes);
+            if (i == n) break;
+        }
+        uint8_t v = lut[in[i]];
+        if (v == BAD) badCharacter("hex", i);
+        i++;
+        if (v == SKIP) continue;
+        if (haveHigh) {
+            out[bytes++] = static_cast<uint8_t>((high << 4) | v);
+        } else {
+            high = v;
+        }
+        haveHigh = !haveHigh;
+    }
+
+    if (haveHigh) {
+        throw std::runtime_error("Hex input has an odd number of digits");
+    }
+    out.resize(bytes);
+    return out;
+}
+
+std::vector<uint8_t> InputDecoder::decodeBase64(const ByteSpan& text) {
+    const uint8_t* lut = tables().base64;
+    const uint8_t* in = text.data();
+    const size_t n = text.size();
+    const SimdLevel level = simdLevel();
+
+    std::vector<uint8_t> out(n / 4 * 3 + 3);
+    size_t bytes = 0;
+    uint32_t acc = 0;
+    unsigned pending = 0;  // symbols in the current group of four
+    unsigned padding = 0;
+
+    size_t i = 0;
+    while (i < n) {
+        if (pending == 0 && padding == 0) {
+            if (level >= SimdLevel::AVX2) i = simd_kernels::base64Avx2(in, out.data(), i, n, bytes);
+            if (level >= SimdLevel::SSE2) i = simd_kernels::base64Sse2(in, out.data(), i, n, bytes);
+            if (i == n) break;
+        }
+        uint8_t c = in[i];
+        uint8_t v = lut[c];
+        if (c == '=') {
+            // Padding may only complete a group that has at least 2 symbols
+            if (pending + padding < 2) badCharacter("base64", i);
+            padding++;
+            if (pending + padding > 4) badCharacter("base64", i);
+            i++;
+            continue;
+        }
+        if (v == BAD || (v != SKIP && padding > 0)) badCharacter("base64", i);
+        i++;
+        if (v == SKIP) continue;
+        acc = (acc << 6) | v;
+        if (++pending == 4) {
+            out[bytes++] = static_cast<uint8_t>(acc >> 16);
+            out[bytes++] = static_cast<uint8_t>(acc >> 8);
+            out[bytes++] = static_cast<uint8_t>(acc);
+            acc = 0;
+            pending = 0;
+        }
+    }
+
+    // A final group of 2 or 3 symbols carries 1 or 2 bytes
+    if (pending == 1) {
+        throw std::runtime_error("Base64 input ends with an incomplete group");
+    }
+    if (pending >= 2) {
+        acc <<= 6 * (4 - pending);
+        out[bytes++] = static_cast<uint8_t>(acc >> 16);
+        if (pending == 3) out[bytes++] = static_cast<uint8_t>(acc >> 8);
+    }
+    out.resize(bytes);
+    return out;
+}
+
+std::vector<uint8_t> InputDecoder::decode(InputFormat format, const ByteSpan& text, size_t& bitCount) {
+    std::vector<uint8_t> out;
+    switch (format) {
+        case InputFormat::AsciiBits:
+            return decodeAsciiBits(text, bitCount);
+        case InputFormat::Hex:
+            out = decodeHex(text);
+            break;
+        case InputFormat::Base64:
+            out = decodeBase64(text);
+            break;
+        case InputFormat::Binary:
+            out.assign(text.begin(), text.end());
+            break;
+    }
+    bitCount = out.size() * 8;
+    return out;
+}
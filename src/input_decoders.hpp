@@ -0,0 +1,35 @@
+// input_decoders.hpp
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "byte_span.hpp"
+
+// How an input file encodes the ciphertext
+enum class InputFormat {
+    Binary,     // raw bytes
+    AsciiBits,  // '0'/'1' characters, MSB first
+    Hex,        // two hex digits per byte, either case
+    Base64      // standard alphabet, '=' padding optional
+};
+
+// Text dump decoders. All of them skip ASCII whitespace anywhere in the
+// input and throw std::runtime_error on any other unexpected character.
+// Runs of 16 or 32 valid characters are decoded by the SIMD kernels
+// simdLevel() selects; whitespace and the tail go through a table-driven
+// scalar path.
+class InputDecoder {
+public:
+    // "binary", "ascii", "hex" or "base64"
+    static InputFormat parseFormat(const std::string& name);
+
+    // Packed MSB-first bytes; `bitCount` receives the number of bits read,
+    // the final byte is zero-padded when it is not a multiple of 8
+    static std::vector<uint8_t> decodeAsciiBits(const ByteSpan& text, size_t& bitCount);
+    static std::vector<uint8_t> decodeHex(const ByteSpan& text);
+    static std::vector<uint8_t> decodeBase64(const ByteSpan& text);
+
+    // Decode any text format; Binary input is copied through unchanged
+    static std::vector<uint8_t> decode(InputFormat format, const ByteSpan& text, size_t& bitCount);
+};
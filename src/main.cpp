@@ -15,15 +15,25 @@
  #include <iomanip>
  #include <map>
  #include <cmath>
+ #include <cctype>
  
  // Include your local headers
  #include "bitsequence.hpp"
+ #include "mapped_file.hpp"
+ #include "input_decoders.hpp"
  #include "nist_sts.hpp"
  #include "stat_analyzer.hpp"
  #include "ca_analyzer.hpp"               // For CellularAutomataProcessor
+ #include "ca2d_processor.hpp"            // For CA2DProcessor
+ #include "ca_denoiser.hpp"               // For CADenoiser
+ #include "byte_filter.hpp"               // For ByteFilterProcessor
+ #include "stream_analyzer.hpp"           // For StreamAnalyzer
+ #include "sidecar_index.hpp"             // For SidecarIndex
+ #include "cpu_features.hpp"              // For simdLevel / setSimdLevel
  #include "visualization_generator.hpp"   // For VisualizationGenerator
  #include "generator_factory.hpp"         // For GeneratorFactory
  #include "test_suite.hpp"                // For TestSuite
+ #include "second_level.hpp"              // For SecondLevelAnalysis
  
  // ----------------------------------------------------------------------------
  // 1. Define a struct for command-line options
@@ -31,14 +41,27 @@
  struct CACACLIOptions {
      std::string inputFile;
      std::string outputFile;
-     bool asciiMode         = false;
+     InputFormat format     = InputFormat::Binary;
      bool verbose           = false;
      bool listGenerators    = false;
      bool testAllGenerators = false;
+     bool streamMode        = false;
+     bool useIndex          = false;
+     bool detectCycles      = false;
+     bool trackGenerations  = false;        // per-generation CA statistics
+     size_t chunkBytes      = size_t(16) << 20;
+     size_t streams         = 1;
+     unsigned threads       = 0;            // 0 = all cores
+     std::string simd;                      // kernel override; empty = detect
      std::string generatorName;
      int iterations         = 5;
      long sequenceLength    = 1000000;
      std::vector<int> caRules{30, 82, 110, 150};
+     std::vector<ByteFilter> byteFilters;   // named -r entries (median9, ...)
+     std::vector<MooreRule> mooreRules;     // 2D rules; none by default
+     size_t gridWidth       = 0;            // 0 = detect
+     EdgeMode edges         = EdgeMode::Mirrored;
+     size_t denoiseWidth    = 0;            // byte rows for the denoiser; 0 = off
  };
  
  // ----------------------------------------------------------------------------
@@ -47,14 +70,29 @@
  static void printUsage(const char* progName) {
      std::cerr << "Usage: " << progName << " [options]\n"
                << "  -f, --file <file>        Input file to analyze\n"
-               << "  -a, --ascii              Treat input as ASCII (default: binary)\n"
+               << "  -a, --ascii              Same as --format ascii\n"
+               << "  -F, --format <fmt>       Input format: binary, ascii, hex, base64 (default: binary)\n"
                << "  -o, --output <file>      Output file prefix\n"
                << "  -g, --generator <name>   Test a specific random number generator\n"
                << "  -G, --all-generators     Test all available generators\n"
                << "  -l, --list               List available generators\n"
                << "  -i, --iterations <n>     Number of CA iterations (default: 5)\n"
                << "  -L, --length <n>         Sequence length for generator tests (default: 1000000)\n"
-               << "  -r, --ca-rules <r1,r2>   Comma-separated CA rules (default: 30,82,110,150)\n"
+               << "  -r, --ca-rules <r1,r2>   Comma-separated Wolfram rules 0-255 (default: 30,82,110,150)\n"
+               << "                           and byte filters min|max|median|open|close<window>,\n"
+               << "                           window odd 3-255 (e.g. 30,110,median9,open31)\n"
+               << "  -m, --moore <B3/S23,..>  Also run 2D Moore-neighbourhood CA rules\n"
+               << "  -W, --width <n|auto>     Row width in bits for 2D rules (default: auto)\n"
+               << "  -E, --edges <mode>       2D edges: mirror, periodic, null (default: mirror)\n"
+               << "  -D, --denoise <width>    Also run the salt-and-pepper denoiser on rows of <width> bytes\n"
+               << "  -s, --stream             Analyze in fixed-size chunks (bounded memory)\n"
+               << "  -c, --chunk-size <MiB>   Chunk size for --stream (default: 16)\n"
+               << "  -n, --streams <N>        Split into N bitstreams and add second-level analysis\n"
+               << "  -j, --threads <N>        Worker threads for CA updates and -n (default: all cores)\n"
+               << "      --simd=<level>       Force SIMD kernels: scalar, sse2, avx2, avx512, auto\n"
+               << "  -T, --track              Print per-generation statistics for each CA rule\n"
+               << "      --cycles             Look for cycles in the CA rules and stop stepping once one repeats\n"
+               << "  -x, --index              Reuse (or create) <file>.cacaidx for the original-data stats\n"
                << "  -v, --verbose            Verbose output\n"
                << "  -h, --help               Show this help\n";
  }
@@ -67,7 +105,14 @@
                << "Examples:\n"
                << "  " << progName << " -f encrypted.bin\n"
                << "  " << progName << " -f input.txt -a -r 30,110\n"
+               << "  " << progName << " -f dump.b64 -F base64\n"
+               << "  " << progName << " -f huge.bin -s -c 64\n"
+               << "  " << progName << " -f capture.bin -x -r 30\n"
+               << "  " << progName << " -f signal.bin -r 30,median15,close7\n"
+               << "  " << progName << " -f image.raw -m B3/S23,B1357/S1357 -W 4096 -E mirror\n"
+               << "  " << progName << " -f photo.gray -D 640 -i 3\n"
                << "  " << progName << " -g \"Linear Congruential\" -L 500000\n"
+               << "  " << progName << " -g \"Linear Congruential\" -L 1000000 -n 100\n"
                << "  " << progName << " -G\n";
  }
  
@@ -82,7 +127,9 @@
          if (arg == "-f" || arg == "--file") {
              if (i + 1 < argc) options.inputFile = argv[++i];
          } else if (arg == "-a" || arg == "--ascii") {
-             options.asciiMode = true;
+             options.format = InputFormat::AsciiBits;
+         } else if (arg == "-F" || arg == "--format") {
+             if (i + 1 < argc) options.format = InputDecoder::parseFormat(argv[++i]);
          } else if (arg == "-o" || arg == "--output") {
              if (i + 1 < argc) options.outputFile = argv[++i];
          } else if (arg == "-g" || arg == "--generator") {
@@ -98,17 +145,67 @@
          } else if (arg == "-r" || arg == "--ca-rules") {
              if (i + 1 < argc) {
                  options.caRules.clear();
+                 options.byteFilters.clear();
                  std::string ruleStr = argv[++i];
+                 auto addRule = [&](const std::string& token) {
+                     if (!token.empty() && std::isalpha(static_cast<unsigned char>(token[0]))) {
+                         options.byteFilters.push_back(ByteFilter::parse(token));
+                     } else {
+                         options.caRules.push_back(std::stoi(token));
+                     }
+                 };
                  size_t pos = 0;
                  while ((pos = ruleStr.find(',')) != std::string::npos) {
-                     std::string token = ruleStr.substr(0, pos);
-                     options.caRules.push_back(std::stoi(token));
+                     addRule(ruleStr.substr(0, pos));
                      ruleStr.erase(0, pos + 1);
                  }
                  if (!ruleStr.empty()) {
-                     options.caRules.push_back(std::stoi(ruleStr));
+                     addRule(ruleStr);
                  }
              }
+         } else if (arg == "-m" || arg == "--moore") {
+             if (i + 1 < argc) {
+                 std::string ruleStr = argv[++i];
+                 size_t pos = 0;
+                 while ((pos = ruleStr.find(',')) != std::string::npos) {
+                     options.mooreRules.push_back(MooreRule::parse(ruleStr.substr(0, pos)));
+                     ruleStr.erase(0, pos + 1);
+                 }
+                 if (!ruleStr.empty()) {
+                     options.mooreRules.push_back(MooreRule::parse(ruleStr));
+                 }
+             }
+         } else if (arg == "-W" || arg == "--width") {
+             if (i + 1 < argc) {
+                 std::string width = argv[++i];
+                 options.gridWidth = (width == "auto") ? 0 : std::stoul(width);
+             }
+         } else if (arg == "-E" || arg == "--edges") {
+             if (i + 1 < argc) options.edges = parseEdgeMode(argv[++i]);
+         } else if (arg == "-D" || arg == "--denoise") {
+             if (i + 1 < argc) options.denoiseWidth = std::stoul(argv[++i]);
+         } else if (arg == "-s" || arg == "--stream") {
+             options.streamMode = true;
+         } else if (arg == "-c" || arg == "--chunk-size") {
+             if (i + 1 < argc) options.chunkBytes = std::stoul(argv[++i]) << 20;
+         } else if (arg == "-n" || arg == "--streams") {
+             if (i + 1 < argc) options.streams = std::stoul(argv[++i]);
+             if (options.streams == 0) {
+                 std::cerr << "Number of streams must be positive\n";
+                 exit(1);
+             }
+         } else if (arg == "-j" || arg == "--threads") {
+             if (i + 1 < argc) options.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+         } else if (arg.rfind("--simd=", 0) == 0) {
+             options.simd = arg.substr(7);
+         } else if (arg == "--simd") {
+             if (i + 1 < argc) options.simd = argv[++i];
+         } else if (arg == "-T" || arg == "--track") {
+             options.trackGenerations = true;
+         } else if (arg == "--cycles") {
+             options.detectCycles = true;
+         } else if (arg == "-x" || arg == "--index") {
+             options.useIndex = true;
          } else if (arg == "-v" || arg == "--verbose") {
              options.verbose = true;
          } else if (arg == "-h" || arg == "--help") {
@@ -126,86 +223,294 @@
  // ----------------------------------------------------------------------------
  // 4. Helper: load data from file
  // ----------------------------------------------------------------------------
- static std::vector<uint8_t> loadDataFromFile(const std::string& filename, bool isAscii) {
-     std::ifstream file(filename, (isAscii ? std::ios::in : std::ios::binary));
-     if (!file) {
-         throw std::runtime_error("Cannot open file: " + filename);
+ // Binary input is memory-mapped and analyzed in place; text dumps are
+ // decoded from the mapping into packed bytes in `decoded`.
+ struct LoadedInput {
+     MappedFile mapped;
+     std::vector<uint8_t> decoded;
+ 
+     ByteSpan bytes() const {
+         return mapped.isOpen() ? mapped.bytes() : ByteSpan(decoded);
+     }
+ };
+ 
+ static void loadDataFromFile(const std::string& filename, InputFormat format, LoadedInput& input) {
+     input.mapped.open(filename);
+     if (format == InputFormat::Binary) {
+         return;
      }
  
-     std::vector<uint8_t> data;
-     if (isAscii) {
-         char ch;
-         while (file.get(ch)) {
-             if (ch == '0') data.push_back(0);
-             else if (ch == '1') data.push_back(1);
-         }
-     } else {
-         // read binary
-         data.assign((std::istreambuf_iterator<char>(file)), 
-                      std::istreambuf_iterator<char>());
+     size_t bitCount = 0;
+     input.decoded = InputDecoder::decode(format, input.mapped.bytes(), bitCount);
+     input.mapped.close();
+ 
+     // The analysis is byte-oriented, so a trailing partial byte is dropped
+     if (bitCount % 8 != 0) {
+         std::cerr << "Warning: ignoring " << bitCount % 8 << " trailing bits\n";
+         input.decoded.resize(bitCount / 8);
      }
-     return data;
  }
  
  // ----------------------------------------------------------------------------
  // 5. Perform CA analysis
  // ----------------------------------------------------------------------------
- static void performCellularAutomataAnalysis(const std::vector<uint8_t>& cipherData,
-                                             const CACACLIOptions& options)
+ // With -n, the data is also split into that many bitstreams, tested in
+ // parallel, and assessed with the SP 800-22 second-level checks.
+ static void printStreamAnalysis(const ByteSpan& data, const CACACLIOptions& options)
+ {
+     using namespace nist_sts;
+     TestSuite suite = TestSuite::createDefaultSuite();
+     TestParameters params = suite.getParameters();
+     params.numOfBitStreams = options.streams;
+     suite.setParameters(params);
+ 
+     BitSequence bits = BitSequence::view(data);
+     auto streamResults = suite.runStreamTests(bits, options.threads);
+     auto secondLevel = SecondLevelAnalysis::evaluate(streamResults);
+     std::cout << SecondLevelAnalysis::formatSummary(secondLevel, options.streams,
+                                                     bits.size() / options.streams) << "\n";
+ }
+ 
+ // With -x, the original data is described by its sidecar index instead of
+ // a rescan: only the tests the index can answer are reported for it.
+ static void printIndexedAnalysis(const ByteSpan& cipherData, const CACACLIOptions& options)
+ {
+     using namespace nist_sts;
+     SidecarIndex index = SidecarIndex::openOrBuild(options.inputFile, cipherData);
+     std::cout << "\n=== Original Data Analysis (NIST Tests, "
+               << (index.wasLoaded() ? "from " : "indexed to ")
+               << SidecarIndex::sidecarPath(options.inputFile) << ") ===\n";
+ 
+     std::vector<TestResult> results{index.frequency(), index.blockFrequency(),
+                                     index.cumulativeSums()};
+     std::cout << NISTTestSuite::formatSummary(results, index.byteCount()) << "\n";
+ 
+     ByteStats stats = index.byteStats();
+     std::cout << "Additional Stats:\n";
+     std::cout << "  Index of Coincidence: " << stats.indexOfCoincidence() << "\n";
+     std::cout << "  Chi-Square:          " << stats.chiSquare() << "\n";
+     std::cout << "  Serial Correlation:  " << stats.serialCorrelation() << "\n";
+ }
+ 
+ // Tests, stats and optional output file for one CA result. `stats` are the
+ // data's byte statistics when the processor already gathered them;
+ // otherwise they are taken here, in one pass.
+ static void reportProcessedData(const ByteSpan& processedData,
+                                 const std::string& outSuffix,
+                                 const CACACLIOptions& options,
+                                 const ByteStats* stats = nullptr)
  {
      using namespace nist_sts;
-     // Print basic info
-     std::cout << "\n=== Original Data Analysis (NIST Tests) ===\n";
      NISTTestSuite nistTester;
-     // Use the test suite’s convenience method or your own method:
-     std::string originalSummary = nistTester.generateSummary(cipherData);
-     std::cout << originalSummary << "\n";
  
-     // Optional additional stats
+     // Run NIST tests on processed data
+     std::string processedSummary = nistTester.generateSummary(processedData);
+     std::cout << processedSummary << "\n";
+     if (options.streams > 1) {
+         printStreamAnalysis(processedData, options);
+     }
+ 
+     // More stats
+     ByteStats scanned;
+     if (!stats) {
+         scanned.add(processedData);
+         stats = &scanned;
+     }
+     double ioc = stats->indexOfCoincidence();
+     double chi = stats->chiSquare();
+     double corr = stats->serialCorrelation();
+ 
      std::cout << "Additional Stats:\n";
-     std::cout << "  Index of Coincidence: " << StatAnalyzer::indexOfCoincidence(cipherData) << "\n";
-     std::cout << "  Chi-Square:          " << StatAnalyzer::chiSquare(cipherData) << "\n";
-     std::cout << "  Serial Correlation:  " << StatAnalyzer::serialCorrelation(cipherData) << "\n";
- 
-     // Now do CA for each rule
-     for (int rule : options.caRules) {
-         std::cout << "\n--- Cellular Automata with Rule " << rule << " ---\n";
-         CellularAutomataProcessor caProcessor(cipherData.size(), rule);
+     std::cout << "  Index of Coincidence: " << ioc << "\n";
+     std::cout << "  Chi-Square:           " << chi << "\n";
+     std::cout << "  Serial Correlation:   " << corr << "\n";
+ 
+     // Optionally write processed data out
+     if (!options.outputFile.empty()) {
+         std::string outName = options.outputFile + outSuffix;
+         std::ofstream outFile(outName, std::ios::binary);
+         outFile.write(reinterpret_cast<const char*>(processedData.data()), processedData.size());
+         std::cout << "Processed data saved to: " << outName << "\n";
+     }
+ }
+ 
+ // With -T: the statistics of every generation of one rule, gathered by the
+ // CA update itself
+ static void printGenerationStats(const MultiRuleCAProcessor& caProcessor, size_t index)
+ {
+     std::cout << "Per-generation statistics:\n"
+               << "  " << std::setw(10) << "Generation" << std::setw(12) << "Ones"
+               << std::setw(14) << "Transitions" << std::setw(14) << "IoC"
+               << std::setw(14) << "Chi-Square" << std::setw(14) << "Serial" << "\n";
+     for (uint64_t t = 0; t <= caProcessor.generation(); t++) {
+         const GenerationStats& stats = caProcessor.generationStats(index, t);
+         std::cout << "  " << std::setw(10) << t << std::setw(12) << stats.ones()
+                   << std::setw(14) << stats.transitions << std::setw(14) << stats.bytes.indexOfCoincidence()
+                   << std::setw(14) << stats.bytes.chiSquare() << std::setw(14) << stats.bytes.serialCorrelation()
+                   << "\n";
+     }
+ }
+ 
+ static void performCellularAutomataAnalysis(const ByteSpan& cipherData,
+                                             const CACACLIOptions& options)
+ {
+     using namespace nist_sts;
+     NISTTestSuite nistTester;
+     if (options.useIndex) {
+         printIndexedAnalysis(cipherData, options);
+     } else {
+         // Print basic info
+         std::cout << "\n=== Original Data Analysis (NIST Tests) ===\n";
+         // Use the test suite’s convenience method or your own method:
+         std::string originalSummary = nistTester.generateSummary(cipherData);
+         std::cout << originalSummary << "\n";
+         if (options.streams > 1) {
+             printStreamAnalysis(cipherData, options);
+         }
+ 
+         // Optional additional stats
+         std::cout << "Additional Stats:\n";
+         std::cout << "  Index of Coincidence: " << StatAnalyzer::indexOfCoincidence(cipherData) << "\n";
+         std::cout << "  Chi-Square:          " << StatAnalyzer::chiSquare(cipherData) << "\n";
+         std::cout << "  Serial Correlation:  " << StatAnalyzer::serialCorrelation(cipherData) << "\n";
+     }
+ 
+     // Now do CA for all the rules in one sweep over the data
+     if (!options.caRules.empty()) {
+         MultiRuleCAProcessor caProcessor(cipherData.size(), options.caRules);
+         caProcessor.setThreads(options.threads);
+         caProcessor.setCycleDetection(options.detectCycles);
+         caProcessor.setStats(options.trackGenerations ? CAStats::Every : CAStats::Final);
          caProcessor.initializeFromCiphertext(cipherData);
  
          auto startTime = std::chrono::high_resolution_clock::now();
-         for (int i = 0; i < options.iterations; i++) {
-             caProcessor.updateCA_SIMD();
+         caProcessor.update(options.iterations);
+         auto endTime = std::chrono::high_resolution_clock::now();
+         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+         std::cout << "\nCA Processing Time (" << caProcessor.ruleCount() << " rules): "
+                   << duration.count() << " ms\n";
+ 
+         for (size_t r = 0; r < caProcessor.ruleCount(); r++) {
+             int rule = caProcessor.getRule(r);
+             std::cout << "\n--- Cellular Automata with Rule " << rule << " ---\n";
+             const CycleDetector& cycle = caProcessor.cycle(r);
+             if (cycle.found()) {
+                 if (cycle.period() == 1) {
+                     std::cout << "Cycle: fixed point after " << cycle.transient() << " generations\n";
+                 } else {
+                     std::cout << "Cycle: period " << cycle.period() << " after a transient of "
+                               << cycle.transient() << " generations\n";
+                 }
+             }
+             if (options.trackGenerations) {
+                 printGenerationStats(caProcessor, r);
+             }
+             const GenerationStats stats = caProcessor.stats(r);
+             reportProcessedData(caProcessor.processedBytes(r), "_rule" + std::to_string(rule), options,
+                                 &stats.bytes);
          }
+     }
+ 
+     // Then each byte filter, on its own copy of the data
+     for (const ByteFilter& filter : options.byteFilters) {
+         ByteFilterProcessor filterProcessor(cipherData.size(), filter);
+         std::cout << "\n--- Byte Filter " << filter.toString() << " ---\n";
+         filterProcessor.initializeFromCiphertext(cipherData);
+ 
+         auto startTime = std::chrono::high_resolution_clock::now();
+         filterProcessor.update(options.iterations);
          auto endTime = std::chrono::high_resolution_clock::now();
          auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
  
-         // Extract processed data
-         auto processedData = caProcessor.extractProcessedData();
+         std::cout << "Processing Time: " << duration.count() << " ms\n";
+         reportProcessedData(filterProcessor.processedBytes(), "_" + filter.toString(), options);
+     }
+ 
+     // And for each 2D rule, on the data reshaped into rows
+     if (!options.mooreRules.empty()) {
+         size_t width = options.gridWidth ? options.gridWidth : CA2DProcessor::detectWidth(cipherData);
+         for (const MooreRule& rule : options.mooreRules) {
+             CA2DProcessor caProcessor(width, cipherData.size() * 8, rule, options.edges);
+             std::cout << "\n--- 2D Cellular Automata with Rule " << rule.toString() << " ("
+                       << caProcessor.getWidth() << "x" << caProcessor.getHeight() << ") ---\n";
+             caProcessor.initializeFromCiphertext(cipherData);
+ 
+             auto startTime = std::chrono::high_resolution_clock::now();
+             caProcessor.update(options.iterations);
+             auto endTime = std::chrono::high_resolution_clock::now();
+             auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+ 
+             std::cout << "Processing Time: " << duration.count() << " ms\n";
+ 
+             std::string suffix = rule.toString();
+             std::replace(suffix.begin(), suffix.end(), '/', '_');
+             reportProcessedData(caProcessor.extractProcessedData(), "_" + suffix, options);
+         }
+     }
+ 
+     // And the denoiser, on the data as a grey-level image
+     if (options.denoiseWidth > 0) {
+         CADenoiser denoiser(options.denoiseWidth, cipherData.size());
+         std::cout << "\n--- Adaptive Median Denoiser (" << denoiser.getWidth() << "x"
+                   << denoiser.getHeight() << ") ---\n";
+         denoiser.initializeFromCiphertext(cipherData);
+         size_t noisyBefore = denoiser.noisyCount();
+ 
+         auto startTime = std::chrono::high_resolution_clock::now();
+         denoiser.update(options.iterations);
+         auto endTime = std::chrono::high_resolution_clock::now();
+         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
  
          std::cout << "Processing Time: " << duration.count() << " ms\n";
+         std::cout << "Noisy bytes (0/255): " << noisyBefore << " -> " << denoiser.noisyCount() << "\n";
+         reportProcessedData(denoiser.processedBytes(), "_denoise", options);
+     }
+ }
  
-         // Run NIST tests on processed data
-         std::string processedSummary = nistTester.generateSummary(processedData);
-         std::cout << processedSummary << "\n";
+ // ----------------------------------------------------------------------------
+ // 5b. Perform CA analysis in bounded memory
+ // ----------------------------------------------------------------------------
+ // Only the tests with chunk-mergeable statistics are run in this mode.
+ static void performStreamingAnalysis(const CACACLIOptions& options)
+ {
+     using namespace nist_sts;
+     StreamOptions streamOptions;
+     streamOptions.chunkBytes = options.chunkBytes;
+     streamOptions.iterations = options.iterations;
+     streamOptions.caRules = options.caRules;
+     if (!options.byteFilters.empty()) {
+         std::cerr << "Note: byte filters are not run in --stream mode\n";
+     }
+     streamOptions.threads = options.threads;
+     streamOptions.detectCycles = options.detectCycles;
+     streamOptions.outputPrefix = options.outputFile;
  
-         // More stats
-         double ioc = StatAnalyzer::indexOfCoincidence(processedData);
-         double chi = StatAnalyzer::chiSquare(processedData);
-         double corr = StatAnalyzer::serialCorrelation(processedData);
+     StreamAnalyzer analyzer(streamOptions);
+     auto startTime = std::chrono::high_resolution_clock::now();
+     analyzer.run(options.inputFile);
+     auto endTime = std::chrono::high_resolution_clock::now();
+     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
  
-         std::cout << "Additional Stats:\n";
-         std::cout << "  Index of Coincidence: " << ioc << "\n";
-         std::cout << "  Chi-Square:           " << chi << "\n";
-         std::cout << "  Serial Correlation:   " << corr << "\n";
- 
-         // Optionally write processed data out
-         if (!options.outputFile.empty()) {
-             std::string outName = options.outputFile + "_rule" + std::to_string(rule);
-             std::ofstream outFile(outName, std::ios::binary);
-             outFile.write(reinterpret_cast<const char*>(processedData.data()), processedData.size());
-             std::cout << "Processed data saved to: " << outName << "\n";
+     if (analyzer.results().empty() || analyzer.results()[0].bytes.count == 0) {
+         throw std::runtime_error("No data read from " + options.inputFile);
+     }
+ 
+     for (const auto& r : analyzer.results()) {
+         if (r.original) {
+             std::cout << "\n=== Original Data Analysis (NIST Tests, streamed) ===\n";
+         } else {
+             std::cout << "\n--- Cellular Automata with Rule " << r.rule << " ---\n";
          }
+         std::cout << NISTTestSuite::formatSummary(r.bits.results(), r.bytes.count) << "\n";
+ 
+         std::cout << "Additional Stats:\n";
+         std::cout << "  Index of Coincidence: " << r.bytes.indexOfCoincidence() << "\n";
+         std::cout << "  Chi-Square:           " << r.bytes.chiSquare() << "\n";
+         std::cout << "  Serial Correlation:   " << r.bytes.serialCorrelation() << "\n";
+     }
+     std::cout << "\nTotal Processing Time: " << duration.count() << " ms\n";
+     if (!options.outputFile.empty()) {
+         std::cout << "Processed data saved to: " << options.outputFile << "_rule<N>\n";
      }
  }
  
@@ -226,20 +531,34 @@
  
      // Create a test suite
      TestSuite suite = TestSuite::createDefaultSuite();
+     TestParameters params = suite.getParameters();
+     params.numOfBitStreams = options.streams;
+     suite.setParameters(params);
+ 
+     // With -n, -L is the length of each stream
+     auto testOne = [&](RandomNumberGenerator& gen) {
+         if (options.streams > 1) {
+             auto streamResults = suite.testGeneratorStreams(gen, options.sequenceLength, options.threads);
+             auto secondLevel = SecondLevelAnalysis::evaluate(streamResults);
+             std::cout << SecondLevelAnalysis::formatSummary(secondLevel, options.streams,
+                                                             options.sequenceLength) << "\n";
+         } else {
+             auto results = suite.testGenerator(gen, options.sequenceLength);
+             std::cout << suite.generateSummary(results) << "\n";
+         }
+     };
  
      if (options.testAllGenerators) {
          std::cout << "Testing All Available Generators...\n";
          auto gens = GeneratorFactory::createAllGenerators();
          for (auto& gen : gens) {
-             auto results = suite.testGenerator(*gen, options.sequenceLength);
-             std::cout << suite.generateSummary(results) << "\n";
+             testOne(*gen);
          }
      } else {
          // Test specific generator
          std::cout << "Testing Generator: " << options.generatorName << "\n";
          auto gen = GeneratorFactory::createGenerator(options.generatorName);
-         auto results = suite.testGenerator(*gen, options.sequenceLength);
-         std::cout << suite.generateSummary(results) << "\n";
+         testOne(*gen);
      }
  }
  
@@ -252,27 +571,54 @@
          return 1;
      }
  
-     // parse CLI
-     CACACLIOptions options = parseCommandLineOptions(argc, argv);
+     try {
+         // parse CLI (rule, filter, edge and format names throw on bad input)
+         CACACLIOptions options = parseCommandLineOptions(argc, argv);
  
-     // If user just wants to list generators, do so and exit
-     if (options.listGenerators && !options.testAllGenerators && options.generatorName.empty()) {
-         performGeneratorAnalysis(options);
-         return 0;
-     }
+         // If user just wants to list generators, do so and exit
+         if (options.listGenerators && !options.testAllGenerators && options.generatorName.empty()) {
+             performGeneratorAnalysis(options);
+             return 0;
+         }
+ 
+         if (!options.simd.empty()) {
+             setSimdLevel(parseSimdLevel(options.simd));
+         }
+         std::cout << "SIMD kernels: " << simdLevelName(simdLevel())
+                   << " (CPU supports " << simdLevelName(detectSimdLevel()) << ")\n";
  
-     try {
          if (!options.generatorName.empty() || options.testAllGenerators) {
              // Perform generator analysis
              performGeneratorAnalysis(options);
+         } else if (!options.inputFile.empty() && options.streamMode) {
+             if (options.format != InputFormat::Binary) {
+                 throw std::runtime_error("--stream supports binary input only");
+             }
+             if (!options.mooreRules.empty()) {
+                 throw std::runtime_error("--moore needs whole rows and cannot be used with --stream");
+             }
+             if (options.useIndex) {
+                 throw std::runtime_error("--index indexes whole files and cannot be used with --stream");
+             }
+             if (options.denoiseWidth > 0) {
+                 throw std::runtime_error("--denoise needs whole rows and cannot be used with --stream");
+             }
+             if (options.trackGenerations) {
+                 throw std::runtime_error("--track reports whole grids and cannot be used with --stream");
+             }
+             performStreamingAnalysis(options);
          } else if (!options.inputFile.empty()) {
              // Perform CA analysis
-             auto data = loadDataFromFile(options.inputFile, options.asciiMode);
-             if (data.empty()) {
+             LoadedInput input;
+             loadDataFromFile(options.inputFile, options.format, input);
+             if (input.bytes().empty()) {
                  std::cerr << "Error: no data read from " << options.inputFile << "\n";
                  return 1;
              }
-             performCellularAutomataAnalysis(data, options);
+             if (options.useIndex && options.format != InputFormat::Binary) {
+                 throw std::runtime_error("--index supports binary input only");
+             }
+             performCellularAutomataAnalysis(input.bytes(), options);
          } else {
              // No input file, no generator -> usage
              printUsage(argv[0]);
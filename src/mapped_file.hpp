@@ -0,0 +1,35 @@
+// mapped_file.hpp
+#pragma once
+#include "byte_span.hpp"
+#include <string>
+
+// Read-only memory mapping of a whole file. Pages are faulted in on demand
+// and the kernel is told to expect a sequential scan, so opening a multi-GB
+// capture is near-instant and costs no extra private memory.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    void open(const std::string& filename);
+    void close();
+
+    bool isOpen() const { return opened; }
+    ByteSpan bytes() const { return ByteSpan(static_cast<const uint8_t*>(address), length); }
+    size_t size() const { return length; }
+
+private:
+    void* address = nullptr;
+    size_t length = 0;
+    bool opened = false;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
@@ -10,29 +10,46 @@ inline double erfc(double x) {
     return std::erfc(x);
 }
 
-// Incomplete gamma function (complementary)
+// Incomplete gamma function (complementary), regularized: Q(a, x)
 inline double igamc(double a, double x) {
-    // Simple implementation of complementary incomplete gamma function
-    if (x < 0.0 || a <= 0.0) return 1.0;
+    if (x <= 0.0 || a <= 0.0) return 1.0;
     
-    // For small x or a
-    if (x < 1.0 || x < a) {
-        // Approximate using series expansion
-        double sum = 1.0;
-        double term = 1.0;
-        double k = 0.0;
-        
-        while (std::abs(term) > std::numeric_limits<double>::epsilon()) {
-            k += 1.0;
-            term *= x / (a + k);
+    const double eps = std::numeric_limits<double>::epsilon();
+    const double tiny = std::numeric_limits<double>::min() / eps;
+    const double logPrefix = -x + a * std::log(x) - std::lgamma(a);
+    
+    if (x < a + 1.0) {
+        // Series for the lower function P(a, x), then Q = 1 - P
+        double ap = a;
+        double term = 1.0 / a;
+        double sum = term;
+        for (int n = 0; n < 10000; n++) {
+            ap += 1.0;
+            term *= x / ap;
             sum += term;
+            if (std::abs(term) < std::abs(sum) * eps) break;
         }
-        
-        return 1.0 - std::pow(x, a) * sum * std::exp(-x) / std::tgamma(a);
+        return 1.0 - sum * std::exp(logPrefix);
     }
     
-    // For large arguments
-    return 0.0;
+    // Continued fraction for Q(a, x) (modified Lentz)
+    double b = x + 1.0 - a;
+    double c = 1.0 / tiny;
+    double d = 1.0 / b;
+    double h = d;
+    for (int i = 1; i < 10000; i++) {
+        double an = -i * (i - a);
+        b += 2.0;
+        d = an * d + b;
+        if (std::abs(d) < tiny) d = tiny;
+        c = b + an / c;
+        if (std::abs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        double delta = d * c;
+        h *= delta;
+        if (std::abs(delta - 1.0) < eps) break;
+    }
+    return std::exp(logPrefix) * h;
 }
 
 // Logarithm of gamma function
@@ -0,0 +1,77 @@
+// median_kernels.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Byte-wise median kernel of the salt-and-pepper denoiser (ca_denoiser.hpp),
+// written against a small set of byte-lane operations (Ops::V holds
+// Ops::Lanes bytes) and instantiated in the simd_kernels_*.cpp units.
+namespace simd_kernels {
+
+// a, b = min(a, b), max(a, b) per byte
+template <typename Ops>
+void sortPair(typename Ops::V& a, typename Ops::V& b) {
+    typename Ops::V low = Ops::minU8(a, b);
+    b = Ops::maxU8(a, b);
+    a = low;
+}
+
+// Replaces every noisy (0 or 255) byte of centre[first, last) with the lower
+// median of the noise-free bytes of its 3x3 window and copies the others to
+// out; up/centre/down[first - 1] and [last] are read as neighbours. The
+// window is sorted with a 25-comparator network; its z zeros sort to the
+// front and its w 255s to the back, so the median is element
+// z + (8 - z - w) / 2. Noisy bytes whose window is all noise are copied
+// unchanged and set `pending`.
+template <typename Ops>
+size_t medianRow(const uint8_t* up, const uint8_t* centre, const uint8_t* down, uint8_t* out,
+                 size_t first, size_t last, bool& pending) {
+    using V = typename Ops::V;
+    static constexpr uint8_t Network[25][2] = {
+        {0, 3}, {1, 7}, {2, 5}, {4, 8}, {0, 7}, {2, 4}, {3, 8}, {5, 6}, {0, 2},
+        {1, 3}, {4, 5}, {7, 8}, {1, 4}, {3, 6}, {5, 7}, {0, 1}, {2, 4}, {3, 5},
+        {6, 8}, {2, 3}, {4, 5}, {6, 7}, {1, 2}, {3, 4}, {5, 6}};
+    const V zero = Ops::set1(0);
+    const V full = Ops::set1(0xFF);
+    const V eight = Ops::set1(8);
+    V unresolved = zero;
+
+    size_t x = first;
+    for (; x + Ops::Lanes <= last; x += Ops::Lanes) {
+        const V c = Ops::load(centre + x);
+        const V noisy = Ops::orV(Ops::eqU8(c, zero), Ops::eqU8(c, full));
+        if (!Ops::any(noisy)) {
+            Ops::store(out + x, c);
+            continue;
+        }
+
+        V v[9] = {Ops::load(up + x - 1),     Ops::load(up + x),     Ops::load(up + x + 1),
+                  Ops::load(centre + x - 1), c,                     Ops::load(centre + x + 1),
+                  Ops::load(down + x - 1),   Ops::load(down + x),   Ops::load(down + x + 1)};
+        V zeros = zero, fulls = zero;
+        for (const V& e : v) {
+            zeros = Ops::subU8(zeros, Ops::eqU8(e, zero));
+            fulls = Ops::subU8(fulls, Ops::eqU8(e, full));
+        }
+        for (const auto& pair : Network) {
+            sortPair<Ops>(v[pair[0]], v[pair[1]]);
+        }
+
+        // clean - 1 = 8 - z - w, which wraps to 255 when nothing is clean
+        const V cleanLess1 = Ops::subU8(Ops::subU8(eight, zeros), fulls);
+        const V allNoise = Ops::eqU8(cleanLess1, full);
+        const V index = Ops::addU8(zeros, Ops::halfU8(cleanLess1));
+        V median = zero;
+        for (int k = 0; k < 9; k++) {
+            median = Ops::orV(median, Ops::andV(Ops::eqU8(index, Ops::set1(static_cast<uint8_t>(k))), v[k]));
+        }
+
+        const V replace = Ops::andNot(allNoise, noisy);
+        unresolved = Ops::orV(unresolved, Ops::andV(noisy, allNoise));
+        Ops::store(out + x, Ops::orV(Ops::andV(replace, median), Ops::andNot(replace, c)));
+    }
+    if (Ops::any(unresolved)) pending = true;
+    return x;
+}
+
+} // namespace simd_kernels
@@ -0,0 +1,58 @@
+// metric_kernels.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Image-quality kernels of image_metrics.hpp, written against a small set of
+// 32-bit lane operations (Ops::V holds Ops::Lanes pixels widened to 32 bits)
+// and instantiated in the simd_kernels_*.cpp units. Ops::mul multiplies
+// lanes below 2^15 only (pmaddwd on zero-extended bytes), which covers every
+// product of two pixels.
+namespace simd_kernels {
+
+// Adds the sum of (a[i] - b[i])^2 over [first, last) to `sum`
+template <typename Ops>
+size_t squaredError(const uint8_t* a, const uint8_t* b, size_t first, size_t last, uint64_t& sum) {
+    using V = typename Ops::V;
+    // A lane gains at most 255^2 per step, so 65536 steps fit its 32 bits
+    constexpr size_t Flush = 65536 * Ops::Lanes;
+    size_t i = first;
+    while (i + Ops::Lanes <= last) {
+        const size_t stop = last - i > Flush ? i + Flush : last;
+        V total = Ops::zero();
+        for (; i + Ops::Lanes <= stop; i += Ops::Lanes) {
+            const V d = Ops::absDiff(a + i, b + i);
+            total = Ops::add(total, Ops::mul(d, d));
+        }
+        sum += Ops::sumLanes(total);
+    }
+    return i;
+}
+
+// Slides column sums of the SSIM window down one row: adds row (xIn, yIn)
+// and drops row (xOut, yOut) at columns [first, last). `moments` holds five
+// rows of `stride` sums: x, y, x^2, y^2 and xy.
+template <typename Ops>
+size_t slideMoments(const uint8_t* xIn, const uint8_t* yIn, const uint8_t* xOut, const uint8_t* yOut,
+                    uint32_t* moments, size_t stride, size_t first, size_t last) {
+    using V = typename Ops::V;
+    uint32_t* sx = moments;
+    uint32_t* sy = moments + stride;
+    uint32_t* sxx = moments + 2 * stride;
+    uint32_t* syy = moments + 3 * stride;
+    uint32_t* sxy = moments + 4 * stride;
+
+    size_t i = first;
+    for (; i + Ops::Lanes <= last; i += Ops::Lanes) {
+        const V xi = Ops::widen(xIn + i), yi = Ops::widen(yIn + i);
+        const V xo = Ops::widen(xOut + i), yo = Ops::widen(yOut + i);
+        Ops::store(sx + i, Ops::add(Ops::load(sx + i), Ops::sub(xi, xo)));
+        Ops::store(sy + i, Ops::add(Ops::load(sy + i), Ops::sub(yi, yo)));
+        Ops::store(sxx + i, Ops::add(Ops::load(sxx + i), Ops::sub(Ops::mul(xi, xi), Ops::mul(xo, xo))));
+        Ops::store(syy + i, Ops::add(Ops::load(syy + i), Ops::sub(Ops::mul(yi, yi), Ops::mul(yo, yo))));
+        Ops::store(sxy + i, Ops::add(Ops::load(sxy + i), Ops::sub(Ops::mul(xi, yi), Ops::mul(xo, yo))));
+    }
+    return i;
+}
+
+} // namespace simd_kernels
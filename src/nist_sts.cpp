@@ -2,21 +2,24 @@
  * File: nist_sts.cpp
  *****************************************************/
 #include "nist_sts.hpp"
+#include "bitsequence.hpp"
 #include "frequency_test.hpp"
 #include "block_frequency_test.hpp"
 #include "runs_test.hpp"
 #include "dft_test.hpp"
 #include "approximate_entropy_test.hpp"
 #include "serial_test.hpp"
+#include "pattern_histogram.hpp"
 // ... plus any other test headers you need ...
 #include <sstream>
 #include <iomanip>
 #include <iostream>
+#include <algorithm>
 #include <cmath>
 
 namespace nist_sts {
 
-std::vector<TestResult> NISTTestSuite::runFrequencyTests(const std::vector<uint8_t>& data) {
+std::vector<TestResult> NISTTestSuite::runFrequencyTests(const BitSequence& data) {
     std::vector<TestResult> results;
     // Frequency (Monobit)
     {
@@ -31,7 +34,12 @@ std::vector<TestResult> NISTTestSuite::runFrequencyTests(const std::vector<uint8
     return results;
 }
 
-std::vector<TestResult> NISTTestSuite::runAllTests(const std::vector<uint8_t>& data) {
+std::vector<TestResult> NISTTestSuite::runAllTests(const ByteSpan& bytes) {
+    // The tests read the caller's bytes in place through a packed view
+    return runAllTests(BitSequence::view(bytes));
+}
+
+std::vector<TestResult> NISTTestSuite::runAllTests(const BitSequence& data) {
     std::vector<TestResult> results;
 
     // 1) Frequency group
@@ -48,28 +56,33 @@ std::vector<TestResult> NISTTestSuite::runAllTests(const std::vector<uint8_t>& d
         DiscreteFourierTransformTest dftTest;
         results.push_back(dftTest.execute(data));
     }
-    // 4) Approximate Entropy
+    // 4) Approximate Entropy and 5) Serial test, both from one pattern
+    // histogram of the higher order they need
     {
         ApproximateEntropyTest appEnt(10);
-        results.push_back(appEnt.execute(data));
-    }
-    // 5) Serial test
-    {
         SerialTest serialT(16);
-        results.push_back(serialT.execute(data));
+        const PatternHistogram histogram(data, std::max(appEnt.patternOrder(), serialT.patternOrder()));
+        results.push_back(appEnt.executeWith(data, histogram));
+        results.push_back(serialT.executeWith(data, histogram));
     }
     // ... add whichever other tests you want ...
 
     return results;
 }
 
-std::string NISTTestSuite::generateSummary(const std::vector<uint8_t>& data) {
-    auto allResults = runAllTests(data);
-    
+std::string NISTTestSuite::generateSummary(const ByteSpan& data) {
+    return formatSummary(runAllTests(data), data.size());
+}
+
+std::string NISTTestSuite::generateSummary(const BitSequence& data) {
+    return formatSummary(runAllTests(data), data.size() / 8);
+}
+
+std::string NISTTestSuite::formatSummary(const std::vector<TestResult>& allResults, size_t byteCount) {
     std::stringstream ss;
     ss << "NIST Statistical Test Suite Results\n"
        << "-----------------------------------\n"
-       << "Data size: " << data.size() << " bytes (" << data.size()*8 << " bits)\n\n"
+       << "Data size: " << byteCount << " bytes (" << byteCount*8 << " bits)\n\n"
        << "Test Name                           p_value      Result\n"
        << "-------------------------------------------------------\n";
 
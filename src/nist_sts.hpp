@@ -6,9 +6,13 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <cstdint>
+#include "byte_span.hpp"
 
 namespace nist_sts {
 
+class BitSequence;
+
 // Forward-declare a struct for test results
 struct TestResult {
     std::string testName;
@@ -24,14 +28,22 @@ public:
     NISTTestSuite() = default;
 
     // Run all tests on the raw data
-    std::vector<TestResult> runAllTests(const std::vector<uint8_t>& data);
+    std::vector<TestResult> runAllTests(const ByteSpan& data);
+
+    // Run all tests on an already decoded sequence; every test reads the
+    // same shared bits
+    std::vector<TestResult> runAllTests(const BitSequence& data);
 
     // Generate a summary string for a given data set
-    std::string generateSummary(const std::vector<uint8_t>& data);
+    std::string generateSummary(const ByteSpan& data);
+    std::string generateSummary(const BitSequence& data);
+
+    // Format results computed elsewhere (e.g. by the streaming accumulators)
+    static std::string formatSummary(const std::vector<TestResult>& results, size_t byteCount);
 
 private:
     // Helper test-group methods
-    std::vector<TestResult> runFrequencyTests(const std::vector<uint8_t>& data);
+    std::vector<TestResult> runFrequencyTests(const BitSequence& data);
     // Add more as needed
 };
 
@@ -0,0 +1,55 @@
+// pattern_histogram.cpp
+#include "pattern_histogram.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace nist_sts {
+
+PatternHistogram::PatternHistogram(const BitSequence& data, size_t m)
+    : m(m), n(data.size()) {
+    if (m == 0 || m > MaxOrder) {
+        throw std::runtime_error("Pattern order must be between 1 and " + std::to_string(MaxOrder));
+    }
+    patternCounts.assign(size_t(1) << m, 0);
+    if (n == 0) return;
+
+    if (n < m) {
+        // Windows wrap more than once; too short to be worth a rolling pass
+        for (size_t i = 0; i < n; i++) {
+            uint64_t p = 0;
+            for (size_t j = 0; j < m; j++) {
+                p = (p << 1) | static_cast<uint64_t>(data[(i + j) % n]);
+            }
+            patternCounts[p]++;
+        }
+        return;
+    }
+
+    uint64_t* counts = patternCounts.data();
+    forEachPattern(data, 0, n, m, [counts](size_t, uint64_t p) { counts[p]++; });
+
+    // The last m-1 windows continue into the first m-1 bits
+    const uint64_t mask = (1ULL << m) - 1;
+    uint64_t window = data.getBits(n - (m - 1), static_cast<unsigned>(m - 1));
+    for (size_t j = 0; j + 1 < m; j++) {
+        window = ((window << 1) | static_cast<uint64_t>(data[j])) & mask;
+        counts[window]++;
+    }
+}
+
+PatternHistogram PatternHistogram::marginal(size_t k) const {
+    if (k == 0 || k > m) {
+        throw std::runtime_error("Marginal order must be between 1 and the histogram order");
+    }
+    PatternHistogram result;
+    result.m = k;
+    result.n = n;
+    result.patternCounts.assign(size_t(1) << k, 0);
+    const unsigned shift = static_cast<unsigned>(m - k);
+    for (size_t p = 0; p < patternCounts.size(); p++) {
+        result.patternCounts[p >> shift] += patternCounts[p];
+    }
+    return result;
+}
+
+} // namespace nist_sts
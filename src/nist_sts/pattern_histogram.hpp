@@ -0,0 +1,56 @@
+// pattern_histogram.hpp
+#pragma once
+#include "bitsequence.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace nist_sts {
+
+// Visit every m-bit window that lies entirely inside [pos, pos + len), in
+// order, as f(start, pattern). The pattern is MSB-first (the window's first
+// bit is its top bit); m must be between 1 and 63.
+template <typename F>
+void forEachPattern(const BitSequence& data, size_t pos, size_t len, size_t m, F&& f) {
+    if (m == 0 || len < m) return;
+    const uint64_t mask = (1ULL << m) - 1;
+    const size_t end = pos + len;
+
+    uint64_t window = data.getBits(pos, static_cast<unsigned>(m - 1));
+    size_t start = pos;
+    for (size_t k = pos + m - 1; k < end;) {
+        unsigned take = static_cast<unsigned>(std::min<size_t>(64, end - k));
+        uint64_t chunk = data.getBits(k, take);
+        for (unsigned b = take; b-- > 0;) {
+            window = ((window << 1) | ((chunk >> b) & 1)) & mask;
+            f(start++, window);
+        }
+        k += take;
+    }
+}
+
+// Cyclic overlapping m-bit pattern counts, as used by the Serial and
+// Approximate Entropy tests: one count per start position i in [0, n), with
+// windows wrapping around to the start of the sequence. Built in one rolling
+// pass into a flat array; lower orders are exact marginals of higher ones.
+class PatternHistogram {
+public:
+    static constexpr size_t MaxOrder = 24;
+
+    PatternHistogram() = default;
+    PatternHistogram(const BitSequence& data, size_t m);
+
+    size_t order() const { return m; }
+    size_t sequenceLength() const { return n; }
+    const std::vector<uint64_t>& counts() const { return patternCounts; }
+
+    // Counts for order k <= order()
+    PatternHistogram marginal(size_t k) const;
+
+private:
+    size_t m = 0;
+    size_t n = 0;
+    std::vector<uint64_t> patternCounts;
+};
+
+} // namespace nist_sts
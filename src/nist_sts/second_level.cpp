@@ -0,0 +1,104 @@
+// second_level.cpp
+#include "second_level.hpp"
+#include "math_functions.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace nist_sts {
+
+SecondLevelResult SecondLevelAnalysis::evaluate(const std::string& testName,
+                                                const std::vector<double>& pValues,
+                                                double alpha) {
+    SecondLevelResult result;
+    result.testName = testName;
+    result.bins.assign(Bins, 0);
+    result.streams = pValues.size();
+
+    for (double p : pValues) {
+        if (p >= alpha) result.passed++;
+        size_t bin = static_cast<size_t>(std::max(0.0, p) * Bins);
+        result.bins[std::min(bin, Bins - 1)]++;
+    }
+    if (result.streams == 0) return result;
+
+    const double s = static_cast<double>(result.streams);
+    const double expectedPass = 1.0 - alpha;
+    const double margin = 3.0 * std::sqrt(expectedPass * alpha / s);
+    result.proportion = result.passed / s;
+    result.proportionMin = expectedPass - margin;
+    result.proportionMax = std::min(1.0, expectedPass + margin);
+
+    if (result.streams >= MinUniformityStreams) {
+        const double expected = s / Bins;
+        double chiSquared = 0.0;
+        for (size_t count : result.bins) {
+            double d = count - expected;
+            chiSquared += d * d / expected;
+        }
+        result.uniformityPValue = igamc((Bins - 1) / 2.0, chiSquared / 2.0);
+        result.uniformityTested = true;
+    }
+    return result;
+}
+
+std::vector<SecondLevelResult> SecondLevelAnalysis::evaluate(const std::vector<TestResults>& streams,
+                                                             double alpha) {
+    std::vector<SecondLevelResult> results;
+    if (streams.empty()) return results;
+
+    const size_t testCount = streams[0].test_results.size();
+    for (size_t t = 0; t < testCount; t++) {
+        std::vector<double> pValues;
+        pValues.reserve(streams.size());
+        for (const auto& stream : streams) {
+            if (t >= stream.test_results.size()) continue;
+            const TestResult& r = stream.test_results[t];
+            if (r.statistics.count("error")) continue;
+            pValues.push_back(r.p_value);
+        }
+        results.push_back(evaluate(streams[0].test_results[t].testName, pValues, alpha));
+    }
+    return results;
+}
+
+std::string SecondLevelAnalysis::formatSummary(const std::vector<SecondLevelResult>& results,
+                                               size_t streamCount, size_t streamLength) {
+    std::stringstream ss;
+    ss << "NIST Second-Level Analysis\n";
+    ss << "--------------------------\n";
+    ss << "Bitstreams: " << streamCount << " x " << streamLength << " bits\n\n";
+
+    ss << " C1  C2  C3  C4  C5  C6  C7  C8  C9 C10  P-Value   Proportion  Test\n";
+    ss << "----------------------------------------------------------------------------\n";
+
+    for (const auto& r : results) {
+        for (size_t count : r.bins) {
+            ss << std::right << std::setw(3) << count << " ";
+        }
+        if (r.uniformityTested) {
+            ss << std::fixed << std::setprecision(6) << std::setw(9) << r.uniformityPValue
+               << (r.uniformityOk() ? " " : "*");
+        } else {
+            ss << "     ---- ";
+        }
+        std::string proportion = "----";
+        if (r.streams > 0) {
+            proportion = std::to_string(r.passed) + "/" + std::to_string(r.streams) +
+                         (r.proportionOk() ? " " : "*");
+        }
+        ss << "  " << std::left << std::setw(11) << proportion << " " << r.testName << "\n";
+    }
+
+    if (!results.empty()) {
+        const SecondLevelResult& r = results[0];
+        ss << "\nMinimum pass proportion: " << std::fixed << std::setprecision(4)
+           << r.proportionMin << " (for " << r.streams << " streams)\n";
+        ss << "Uniformity needs at least " << MinUniformityStreams
+           << " streams; '*' marks a failed assessment\n";
+    }
+    return ss.str();
+}
+
+} // namespace nist_sts
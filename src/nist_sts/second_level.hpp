@@ -0,0 +1,50 @@
+// second_level.hpp
+#pragma once
+#include "common.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace nist_sts {
+
+// Second-level assessment of one test over many bitstreams (SP 800-22,
+// section 4.2): the proportion of streams that pass must lie within
+// p ± 3 sqrt(p (1 - p) / s) for p = 1 - alpha, and the p-values must be
+// uniform over ten bins (chi-square P-value of at least 0.0001).
+struct SecondLevelResult {
+    std::string testName;
+    size_t streams = 0;             // streams with a usable p-value
+    size_t passed = 0;
+    std::vector<size_t> bins;       // p-value histogram over [0, 1)
+    double proportion = 0.0;
+    double proportionMin = 0.0;
+    double proportionMax = 0.0;
+    double uniformityPValue = 0.0;
+    bool uniformityTested = false;  // needs MinUniformityStreams streams
+
+    bool proportionOk() const {
+        return streams > 0 && proportion >= proportionMin && proportion <= proportionMax;
+    }
+    bool uniformityOk() const { return !uniformityTested || uniformityPValue >= 0.0001; }
+};
+
+class SecondLevelAnalysis {
+public:
+    static constexpr size_t Bins = 10;
+    static constexpr size_t MinUniformityStreams = 55;
+
+    // One result per test; streams[s] holds stream s's results with the
+    // tests in the same order. Results flagged with an "error" statistic
+    // (sequence too short for the test) are left out.
+    static std::vector<SecondLevelResult> evaluate(const std::vector<TestResults>& streams,
+                                                   double alpha = ALPHA);
+
+    static SecondLevelResult evaluate(const std::string& testName,
+                                      const std::vector<double>& pValues,
+                                      double alpha = ALPHA);
+
+    static std::string formatSummary(const std::vector<SecondLevelResult>& results,
+                                     size_t streamCount, size_t streamLength);
+};
+
+} // namespace nist_sts
@@ -0,0 +1,123 @@
+// stream_accumulator.cpp
+#include "stream_accumulator.hpp"
+#include "frequency_test.hpp"
+#include "runs_test.hpp"
+#include "cumulative_sums_test.hpp"
+#include "serial_test.hpp"
+#include "bit_utils.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace nist_sts {
+
+namespace {
+
+double psiSquared(const std::vector<uint64_t>& counts, size_t m, size_t n) {
+    double sum = 0.0;
+    for (uint64_t c : counts) {
+        sum += static_cast<double>(c) * static_cast<double>(c);
+    }
+    return sum * static_cast<double>(1ULL << m) / static_cast<double>(n) - static_cast<double>(n);
+}
+
+} // namespace
+
+BitStreamAccumulator::BitStreamAccumulator(size_t serialBlockLength)
+    : m(serialBlockLength), patternCounts(size_t(1) << serialBlockLength, 0) {
+    if (m < 2 || m > 24) {
+        throw std::runtime_error("Serial block length must be between 2 and 24");
+    }
+}
+
+void BitStreamAccumulator::add(const ByteSpan& data) {
+    const ByteWalkTable& walk = byteWalkTable();
+    const uint64_t mask = (1ULL << m) - 1;
+
+    for (size_t i = 0; i < data.size(); i++) {
+        uint8_t b = data[i];
+
+        ones += popcount64(b);
+        if (bitCount > 0) transitions += lastBit ^ (b >> 7);
+        transitions += popcount64((b ^ (b >> 1)) & 0x7F);
+        lastBit = b & 1;
+
+        maxSum = std::max(maxSum, partialSum + walk.prefixMax[b]);
+        minSum = std::min(minSum, partialSum + walk.prefixMin[b]);
+        partialSum += walk.delta[b];
+
+        // Patterns ending at each of the 8 new bits; the first m-1 bits of
+        // the sequence only seed the window (and are saved for the wrap)
+        window = (window << 8) | b;
+        for (int k = 7; k >= 0; k--) {
+            size_t end = bitCount + 8 - k;  // bits consumed after this one
+            if (end >= m) {
+                patternCounts[(window >> k) & mask]++;
+            } else if (end == m - 1) {
+                head = (window >> k) & (mask >> 1);
+            }
+        }
+        bitCount += 8;
+    }
+}
+
+TestResult BitStreamAccumulator::frequency() const {
+    TestResult result = FrequencyTest::evaluate(ones, bitCount);
+    result.testName = "Frequency";
+    return result;
+}
+
+TestResult BitStreamAccumulator::runs() const {
+    TestResult result = RunsTest::evaluate(ones, transitions + 1, bitCount);
+    result.testName = "Runs";
+    return result;
+}
+
+TestResult BitStreamAccumulator::cumulativeSums() const {
+    long long z = std::max(maxSum, -minSum);
+    long long zRev = std::max(partialSum - minSum, maxSum - partialSum);
+    TestResult result = CumulativeSumsTest::evaluate(bitCount, z, zRev);
+    result.testName = "Cumulative Sums";
+    return result;
+}
+
+TestResult BitStreamAccumulator::serial() const {
+    if (bitCount < m) {
+        TestResult result;
+        result.testName = "Serial";
+        result.p_value = 0.0;
+        result.success = false;
+        result.statistics["error"] = 1.0;
+        return result;
+    }
+
+    // Close the cyclic patterns that start in the last m-1 bits
+    const uint64_t mask = (1ULL << m) - 1;
+    std::vector<uint64_t> counts = patternCounts;
+    uint64_t w = window;
+    for (size_t k = m - 1; k-- > 0;) {
+        w = (w << 1) | ((head >> k) & 1);
+        counts[w & mask]++;
+    }
+
+    // The (m-1)- and (m-2)-bit cyclic counts are marginals of the m-bit ones
+    std::vector<uint64_t> counts1(counts.size() / 2, 0);
+    std::vector<uint64_t> counts2(counts.size() / 4, 0);
+    for (size_t p = 0; p < counts.size(); p++) {
+        counts1[p >> 1] += counts[p];
+        counts2[p >> 2] += counts[p];
+    }
+
+    double psim0 = psiSquared(counts, m, bitCount);
+    double psim1 = psiSquared(counts1, m - 1, bitCount);
+    double psim2 = (m > 2) ? psiSquared(counts2, m - 2, bitCount) : 0.0;
+
+    TestResult result = SerialTest::evaluate(m, psim0, psim1, psim2);
+    result.testName = "Serial";
+    return result;
+}
+
+std::vector<TestResult> BitStreamAccumulator::results() const {
+    return {frequency(), runs(), cumulativeSums(), serial()};
+}
+
+} // namespace nist_sts
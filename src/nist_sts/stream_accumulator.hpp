@@ -0,0 +1,53 @@
+// stream_accumulator.hpp
+#pragma once
+#include "common.hpp"
+#include "byte_span.hpp"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace nist_sts {
+
+// Chunk-fed state for the tests whose statistics can be carried across chunk
+// boundaries: Frequency, Runs, Cumulative Sums and Serial. Feeding a sequence
+// in any split gives the same results as running the tests on it in one piece,
+// with memory independent of the sequence length (2^m counters for Serial).
+class BitStreamAccumulator {
+public:
+    explicit BitStreamAccumulator(size_t serialBlockLength = 16);
+
+    // Append packed bytes (MSB-first, as in BitSequence)
+    void add(const ByteSpan& data);
+
+    size_t size() const { return bitCount; }
+
+    TestResult frequency() const;
+    TestResult runs() const;
+    TestResult cumulativeSums() const;
+    TestResult serial() const;
+
+    // All of the above, in that order
+    std::vector<TestResult> results() const;
+
+private:
+    size_t bitCount = 0;
+    size_t ones = 0;
+
+    // Runs: adjacent bit pairs that differ, plus the last bit seen
+    size_t transitions = 0;
+    unsigned lastBit = 0;
+
+    // Cumulative sums: running +/-1 sum and its extremes (including S_0 = 0)
+    long long partialSum = 0;
+    long long maxSum = 0;
+    long long minSum = 0;
+
+    // Serial: cyclic m-bit pattern counts. The first m-1 bits are kept to
+    // close the wrap-around patterns when the results are requested.
+    size_t m;
+    uint64_t window = 0;
+    uint64_t head = 0;
+    std::vector<uint64_t> patternCounts;
+};
+
+} // namespace nist_sts
@@ -2,8 +2,9 @@
 #include "approximate_entropy_test.hpp"
 #include "common.hpp"
 #include "math_functions.hpp"
+#include "pattern_histogram.hpp"
 #include <cmath>
-#include <unordered_map>
+#include <stdexcept>
 #include <string>
 
 namespace nist_sts {
@@ -12,23 +13,34 @@ ApproximateEntropyTest::ApproximateEntropyTest(size_t blockLength)
     : blockLength(blockLength) {}
 
 TestResult ApproximateEntropyTest::execute(const BitSequence& data) {
+    if (patternOrder() == 0) {
+        return executeWith(data, PatternHistogram());
+    }
+    return executeWith(data, PatternHistogram(data, blockLength + 1));
+}
+
+TestResult ApproximateEntropyTest::executeWith(const BitSequence& data, const PatternHistogram& histogram) {
     TestResult result;
     result.testName = getName();
     
     // Ensure we have enough data
-    if (data.size() < blockLength) {
+    if (data.size() < blockLength || blockLength + 1 > PatternHistogram::MaxOrder) {
         result.p_value = 0.0;
         result.success = false;
         result.statistics["error"] = 1.0;
         return result;
     }
+    if (histogram.order() < blockLength + 1 || histogram.sequenceLength() != data.size()) {
+        throw std::runtime_error("Approximate Entropy test needs a pattern histogram of the sequence "
+                                 "of order " + std::to_string(blockLength + 1));
+    }
     
     // Calculate ApEn (m) and ApEn (m+1)
     double ApEn[2];
     
-    // Calculate phi(m) and phi(m+1)
-    ApEn[0] = calculatePhi(data, blockLength);
-    ApEn[1] = calculatePhi(data, blockLength + 1);
+    // Calculate phi(m) and phi(m+1), both from the (m+1)-bit counts
+    ApEn[0] = calculatePhi(histogram, blockLength);
+    ApEn[1] = calculatePhi(histogram, blockLength + 1);
     
     // Calculate ApEn
     double apen = ApEn[0] - ApEn[1];
@@ -58,26 +70,21 @@ TestResult ApproximateEntropyTest::execute(const BitSequence& data) {
     return result;
 }
 
-double ApproximateEntropyTest::calculatePhi(const BitSequence& data, size_t m) {
+double ApproximateEntropyTest::calculatePhi(const PatternHistogram& histogram, size_t m) {
     if (m == 0 || m == static_cast<size_t>(-1)) {
         return 0.0;
     }
     
-    // Count frequencies of m-bit patterns
-    std::unordered_map<std::string, int> frequencies;
-    
-    for (size_t i = 0; i < data.size(); i++) {
-        std::string pattern;
-        for (size_t j = 0; j < m; j++) {
-            pattern += data[(i + j) % data.size()] ? '1' : '0';
-        }
-        frequencies[pattern]++;
-    }
+    // Frequencies of the cyclic m-bit patterns
+    PatternHistogram lower;
+    const PatternHistogram& h = (m == histogram.order()) ? histogram : (lower = histogram.marginal(m));
     
     // Calculate phi(m)
+    double n = static_cast<double>(h.sequenceLength());
     double sum = 0.0;
-    for (const auto& pair : frequencies) {
-        double probability = static_cast<double>(pair.second) / data.size();
+    for (uint64_t count : h.counts()) {
+        if (count == 0) continue;
+        double probability = static_cast<double>(count) / n;
         sum += probability * std::log(probability);
     }
     
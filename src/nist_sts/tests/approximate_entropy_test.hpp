@@ -2,6 +2,7 @@
 #pragma once
 #include "statistical_test.hpp"
 #include "bitsequence.hpp"
+#include "pattern_histogram.hpp"
 
 namespace nist_sts {
 
@@ -13,12 +14,18 @@ public:
     explicit ApproximateEntropyTest(size_t blockLength = 10);
     TestResult execute(const BitSequence& data) override;
     std::string getName() const override { return "Approximate Entropy"; }
+
+    // phi for m and m+1 both come from the (m+1)-bit counts
+    size_t patternOrder() const override {
+        return blockLength + 1 <= PatternHistogram::MaxOrder ? blockLength + 1 : 0;
+    }
+    TestResult executeWith(const BitSequence& data, const PatternHistogram& histogram) override;
     
     void setBlockLength(size_t length) { blockLength = length; }
     size_t getBlockLength() const { return blockLength; }
     
 private:
-    double calculatePhi(const BitSequence& data, size_t m);
+    static double calculatePhi(const PatternHistogram& histogram, size_t m);
 };
 
 } // namespace nist_sts
\ No newline at end of file
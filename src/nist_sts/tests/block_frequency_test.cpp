@@ -27,12 +27,8 @@ TestResult BlockFrequencyTest::execute(const BitSequence& data) {
     
     // Process each block
     for (int i = 0; i < N; i++) {
-        int blockSum = 0;
-        
         // Count ones in the block
-        for (size_t j = 0; j < blockLength; j++) {
-            blockSum += data[j + i * blockLength];
-        }
+        size_t blockSum = data.countOnes(i * blockLength, blockLength);
         
         // Calculate proportion of ones in the block
         double pi = static_cast<double>(blockSum) / blockLength;
@@ -42,8 +38,16 @@ TestResult BlockFrequencyTest::execute(const BitSequence& data) {
         sum += v * v;
     }
     
+    return evaluate(data.size(), blockLength, sum);
+}
+
+TestResult BlockFrequencyTest::evaluate(size_t n, size_t blockLength, double sumSquaredDeviations) {
+    TestResult result;
+    result.testName = "Block Frequency";
+    size_t N = n / blockLength;
+    
     // Calculate final chi-squared statistic
-    double chi_squared = 4.0 * blockLength * sum;
+    double chi_squared = 4.0 * blockLength * sumSquaredDeviations;
     
     // Calculate p-value using incomplete gamma function
     double p_value = igamc(N / 2.0, chi_squared / 2.0);
@@ -52,10 +56,10 @@ TestResult BlockFrequencyTest::execute(const BitSequence& data) {
     result.statistics["chi_squared"] = chi_squared;
     result.statistics["num_blocks"] = N;
     result.statistics["block_length"] = blockLength;
-    result.statistics["discarded_bits"] = data.size() % blockLength;
+    result.statistics["discarded_bits"] = n % blockLength;
     
     result.p_value = p_value;
-    result.success = isSuccess(p_value);
+    result.success = p_value >= ALPHA;
     
     return result;
 }
@@ -13,6 +13,10 @@ public:
     explicit BlockFrequencyTest(size_t blockLength = 128);
     TestResult execute(const BitSequence& data) override;
     std::string getName() const override { return "Block Frequency"; }
+
+    // Evaluate from the sum over the N blocks of (ones / blockLength - 1/2)^2
+    // (shared with the sidecar index)
+    static TestResult evaluate(size_t n, size_t blockLength, double sumSquaredDeviations);
     
     void setBlockLength(size_t length) { blockLength = length; }
     size_t getBlockLength() const { return blockLength; }
@@ -8,9 +8,6 @@
 namespace nist_sts {
 
 TestResult CumulativeSumsTest::execute(const BitSequence& data) {
-    TestResult result;
-    result.testName = getName();
-    
     // Initialize variables
     int S = 0;
     int sup = 0;
@@ -38,37 +35,48 @@ TestResult CumulativeSumsTest::execute(const BitSequence& data) {
     
     int zRev = std::max(supRev, -infRev);
     
+    TestResult result = evaluate(data.size(), z, zRev);
+    result.testName = getName();
+    return result;
+}
+
+TestResult CumulativeSumsTest::evaluate(size_t n, long long z, long long zRev) {
+    TestResult result;
+    
     // Calculate p-values for forward and backward modes
-    double p_value_forward = calculatePValue(data.size(), z);
-    double p_value_backward = calculatePValue(data.size(), zRev);
+    double p_value_forward = calculatePValue(n, z);
+    double p_value_backward = calculatePValue(n, zRev);
     
     // Store results
-    result.statistics["forward_max_partial_sum"] = z;
-    result.statistics["backward_max_partial_sum"] = zRev;
+    result.statistics["forward_max_partial_sum"] = static_cast<double>(z);
+    result.statistics["backward_max_partial_sum"] = static_cast<double>(zRev);
     result.statistics["p_value_forward"] = p_value_forward;
     result.statistics["p_value_backward"] = p_value_backward;
     
     // Use the minimum p-value as the test result
     result.p_value = std::min(p_value_forward, p_value_backward);
-    result.success = isSuccess(result.p_value);
+    result.success = (result.p_value >= ALPHA);
     
     return result;
 }
 
-double CumulativeSumsTest::calculatePValue(size_t n, int z) {
+double CumulativeSumsTest::calculatePValue(size_t n, long long z) {
     double sum1 = 0.0;
     double sum2 = 0.0;
+    // 64-bit bounds: streamed inputs can exceed 2^31 bits
+    long long nz = static_cast<long long>(n) / z;
+    double sqrtN = std::sqrt(static_cast<double>(n));
     
     // Calculate first sum
-    for (int k = (-static_cast<int>(n) / z + 1) / 4; k <= (static_cast<int>(n) / z - 1) / 4; k++) {
-        sum1 += normal(((4 * k + 1) * z) / std::sqrt(static_cast<double>(n)));
-        sum1 -= normal(((4 * k - 1) * z) / std::sqrt(static_cast<double>(n)));
+    for (long long k = (-nz + 1) / 4; k <= (nz - 1) / 4; k++) {
+        sum1 += normal(static_cast<double>((4 * k + 1) * z) / sqrtN);
+        sum1 -= normal(static_cast<double>((4 * k - 1) * z) / sqrtN);
     }
     
     // Calculate second sum
-    for (int k = (-static_cast<int>(n) / z - 3) / 4; k <= (static_cast<int>(n) / z - 1) / 4; k++) {
-        sum2 += normal(((4 * k + 3) * z) / std::sqrt(static_cast<double>(n)));
-        sum2 -= normal(((4 * k + 1) * z) / std::sqrt(static_cast<double>(n)));
+    for (long long k = (-nz - 3) / 4; k <= (nz - 1) / 4; k++) {
+        sum2 += normal(static_cast<double>((4 * k + 3) * z) / sqrtN);
+        sum2 -= normal(static_cast<double>((4 * k + 1) * z) / sqrtN);
     }
     
     double p_value = 1.0 - sum1 + sum2;
@@ -11,10 +11,14 @@ public:
     TestResult execute(const BitSequence& data) override;
     std::string getName() const override { return "Cumulative Sums"; }
 
+    // Evaluate from the forward/backward maximum partial sums (shared with the
+    // streaming accumulators)
+    static TestResult evaluate(size_t n, long long z, long long zRev);
+
 private:
     // Add missing method declarations
-    double calculatePValue(size_t n, int z);
-    double normal(double x);
+    static double calculatePValue(size_t n, long long z);
+    static double normal(double x);
 
 };
 
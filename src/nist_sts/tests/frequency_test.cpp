@@ -7,22 +7,25 @@
 namespace nist_sts {
 
 TestResult FrequencyTest::execute(const BitSequence& data) {
-    TestResult result;
+    TestResult result = evaluate(data.countOnes(), data.size());
     result.testName = getName();
+    return result;
+}
+
+TestResult FrequencyTest::evaluate(size_t ones, size_t n) {
+    TestResult result;
     
-    double sum = 0.0;
-    for (size_t i = 0; i < data.size(); i++) {
-        sum += 2 * static_cast<int>(data[i]) - 1;  // Convert to +1/-1
-    }
+    // Sum of the +1/-1 sequence is 2 * ones - n
+    double sum = 2.0 * static_cast<double>(ones) - static_cast<double>(n);
     
-    double s_obs = std::abs(sum) / std::sqrt(static_cast<double>(data.size()));
+    double s_obs = std::abs(sum) / std::sqrt(static_cast<double>(n));
     double p_value = erfc(s_obs / std::sqrt(2.0));
     
     result.statistics["sum"] = sum;
     result.statistics["s_obs"] = s_obs;
-    result.statistics["normalized_sum"] = sum / data.size();
+    result.statistics["normalized_sum"] = sum / n;
     result.p_value = p_value;
-    result.success = isSuccess(p_value);
+    result.success = (p_value >= ALPHA);
     
     return result;
 }
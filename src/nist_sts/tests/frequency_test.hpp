@@ -10,6 +10,9 @@ public:
     FrequencyTest() = default;
     TestResult execute(const BitSequence& data) override;
     std::string getName() const override { return "Frequency"; }
+
+    // Evaluate from pre-computed counts (shared with the streaming accumulators)
+    static TestResult evaluate(size_t ones, size_t n);
 };
 
 } // namespace nist_sts
\ No newline at end of file
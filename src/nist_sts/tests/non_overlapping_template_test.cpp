@@ -2,6 +2,7 @@
 #include "non_overlapping_template_test.hpp"
 #include "common.hpp"
 #include "math_functions.hpp"
+#include "pattern_histogram.hpp"
 #include <cmath>
 #include <fstream>
 #include <stdexcept>
@@ -20,7 +21,8 @@ TestResult NonOverlappingTemplateTest::execute(const BitSequence& data) {
     result.testName = getName();
     
     // Ensure we have enough data and templates
-    if (data.size() < 8 * blockLength || templates.empty()) {
+    if (data.size() < 8 * blockLength || templates.empty() ||
+        blockLength == 0 || blockLength > PatternHistogram::MaxOrder) {
         result.p_value = 0.0;
         result.success = false;
         result.statistics["error"] = 1.0;
@@ -50,33 +52,37 @@ TestResult NonOverlappingTemplateTest::execute(const BitSequence& data) {
     // Store overall minimum p-value
     double min_p_value = 1.0;
     
-    // Process each template
+    // Map each pattern value to the first template with that value, so one
+    // pass over the windows counts all templates at once
+    std::vector<int> templateIndex(size_t(1) << blockLength, -1);
+    std::vector<int> canonical(templateCount);
     for (int t = 0; t < templateCount; t++) {
-        const std::vector<bool>& templ = templates[t];
-        
-        // Counters for each block
-        std::vector<unsigned int> W(N, 0);
-        
-        // Process each block
-        for (int i = 0; i < N; i++) {
-            // Process positions within the block
-            for (int j = 0; j < M - blockLength + 1; j++) {
-                bool match = true;
-                
-                // Check if template matches at this position
-                for (size_t k = 0; k < blockLength; k++) {
-                    if (templ[k] != data[i * M + j + k]) {
-                        match = false;
-                        break;
-                    }
-                }
-                
-                if (match) {
-                    W[i]++;
-                    j += blockLength - 1;  // Skip ahead (non-overlapping)
-                }
-            }
+        uint64_t value = 0;
+        for (size_t k = 0; k < blockLength; k++) {
+            value = (value << 1) | static_cast<uint64_t>(k < templates[t].size() && templates[t][k]);
         }
+        if (templateIndex[value] < 0) templateIndex[value] = t;
+        canonical[t] = templateIndex[value];
+    }
+    
+    // Counters for each template and block
+    std::vector<std::vector<unsigned int>> counts(templateCount, std::vector<unsigned int>(N, 0));
+    for (int i = 0; i < N; i++) {
+        // After a match the next m-1 positions are skipped (non-overlapping)
+        std::vector<size_t> nextAllowed(templateCount, 0);
+        forEachPattern(data, static_cast<size_t>(i) * M, M, blockLength,
+                       [&](size_t start, uint64_t pattern) {
+            int t = templateIndex[pattern];
+            if (t >= 0 && start >= nextAllowed[t]) {
+                counts[t][i]++;
+                nextAllowed[t] = start + blockLength;
+            }
+        });
+    }
+    
+    // Process each template
+    for (int t = 0; t < templateCount; t++) {
+        const std::vector<unsigned int>& W = counts[canonical[t]];
         
         // Calculate chi-squared statistic
         double chi_squared = 0.0;
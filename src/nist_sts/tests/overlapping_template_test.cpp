@@ -2,6 +2,7 @@
 #include "overlapping_template_test.hpp"
 #include "common.hpp"
 #include "math_functions.hpp"
+#include "pattern_histogram.hpp"
 #include <cmath>
 #include <vector>
 
@@ -18,7 +19,8 @@ TestResult OverlappingTemplateTest::execute(const BitSequence& data) {
     result.testName = getName();
     
     // Ensure we have enough data
-    if (data.size() < 1032) {  // This is the standard minimum size for this test
+    if (data.size() < 1032 ||  // This is the standard minimum size for this test
+        template_.size() != blockLength || blockLength == 0 || blockLength > 32) {
         result.p_value = 0.0;
         result.success = false;
         result.statistics["error"] = 1.0;
@@ -40,26 +42,21 @@ TestResult OverlappingTemplateTest::execute(const BitSequence& data) {
     // Initialize frequency counts
     std::vector<unsigned int> nu(K + 1, 0);
     
+    // Template as an MSB-first pattern value
+    uint64_t target = 0;
+    for (size_t k = 0; k < blockLength; k++) {
+        target = (target << 1) | static_cast<uint64_t>(template_[k]);
+    }
+    
     // Process each substring
     for (int i = 0; i < N; i++) {
         int W_obs = 0;  // Number of template matches in this substring
         
-        // Check for matches in the current substring
-        for (int j = 0; j < M - blockLength + 1; j++) {
-            bool match = true;
-            
-            // Check if the template matches at this position
-            for (size_t k = 0; k < blockLength; k++) {
-                if (template_[k] != data[i * M + j + k]) {
-                    match = false;
-                    break;
-                }
-            }
-            
-            if (match) {
-                W_obs++;
-            }
-        }
+        // Check for matches at every position of the current substring
+        forEachPattern(data, static_cast<size_t>(i) * M, M, blockLength,
+                       [&](size_t, uint64_t pattern) {
+            if (pattern == target) W_obs++;
+        });
         
         // Update frequency count
         if (W_obs <= 4) {
@@ -1,20 +1,35 @@
 // runs_test.cpp
 #include "runs_test.hpp"
 #include "common.hpp"
+#include "bit_utils.hpp"
 #include <cmath>
+#include <algorithm>
 
 namespace nist_sts {
 
 TestResult RunsTest::execute(const BitSequence& data) {
-    TestResult result;
+    // Count runs: one plus the number of adjacent bit pairs that differ.
+    // Windows of 64 bits overlap by one so every pair is seen exactly once.
+    size_t V = 1;  // Start with 1 for the first run
+    for (size_t k = 0; k + 1 < data.size(); k += 63) {
+        unsigned count = static_cast<unsigned>(std::min<size_t>(64, data.size() - k));
+        uint64_t w = data.getBits(k, count);
+        V += popcount64((w ^ (w >> 1)) & ((1ULL << (count - 1)) - 1));
+    }
+
+    TestResult result = evaluate(data.countOnes(), V, data.size());
     result.testName = getName();
+    return result;
+}
+
+TestResult RunsTest::evaluate(size_t ones, size_t V, size_t n) {
+    TestResult result;
     
     // Calculate proportion of ones
-    size_t S = data.countOnes();
-    double pi = static_cast<double>(S) / static_cast<double>(data.size());
+    double pi = static_cast<double>(ones) / static_cast<double>(n);
     
     // Pre-test: check if proportion is close to 1/2
-    if (std::abs(pi - 0.5) > (2.0 / std::sqrt(static_cast<double>(data.size())))) {
+    if (std::abs(pi - 0.5) > (2.0 / std::sqrt(static_cast<double>(n)))) {
         result.p_value = 0.0;
         result.success = false;
         result.statistics["pi"] = pi;
@@ -22,17 +37,9 @@ TestResult RunsTest::execute(const BitSequence& data) {
         return result;
     }
     
-    // Count runs
-    size_t V = 1;  // Start with 1 for the first run
-    for (size_t k = 1; k < data.size(); k++) {
-        if (data[k] != data[k-1]) {
-            V++;
-        }
-    }
-    
     // Calculate test statistic
-    double erfc_arg = std::abs(static_cast<double>(V) - 2.0 * static_cast<double>(data.size()) * pi * (1-pi)) / 
-                     (2.0 * pi * (1-pi) * std::sqrt(2.0 * static_cast<double>(data.size())));
+    double erfc_arg = std::abs(static_cast<double>(V) - 2.0 * static_cast<double>(n) * pi * (1-pi)) / 
+                     (2.0 * pi * (1-pi) * std::sqrt(2.0 * static_cast<double>(n)));
     
     // Calculate p-value
     double p_value = erfc(erfc_arg);
@@ -43,7 +50,7 @@ TestResult RunsTest::execute(const BitSequence& data) {
     result.statistics["erfc_arg"] = erfc_arg;
     
     result.p_value = p_value;
-    result.success = isSuccess(p_value);
+    result.success = (p_value >= ALPHA);
     
     return result;
 }
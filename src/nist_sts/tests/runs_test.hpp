@@ -10,6 +10,9 @@ public:
     RunsTest() = default;
     TestResult execute(const BitSequence& data) override;
     std::string getName() const override { return "Runs"; }
+
+    // Evaluate from pre-computed counts (shared with the streaming accumulators)
+    static TestResult evaluate(size_t ones, size_t runs, size_t n);
 };
 
 } // namespace nist_sts
\ No newline at end of file
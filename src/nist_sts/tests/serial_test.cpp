@@ -2,8 +2,9 @@
 #include "serial_test.hpp"
 #include "common.hpp"
 #include "math_functions.hpp"
+#include "pattern_histogram.hpp"
 #include <cmath>
-#include <unordered_map>
+#include <stdexcept>
 #include <string>
 
 namespace nist_sts {
@@ -12,29 +13,48 @@ SerialTest::SerialTest(size_t blockLength)
     : blockLength(blockLength) {}
 
 TestResult SerialTest::execute(const BitSequence& data) {
-    TestResult result;
-    result.testName = getName();
-    
+    if (patternOrder() == 0) {
+        return executeWith(data, PatternHistogram());
+    }
+    return executeWith(data, PatternHistogram(data, blockLength));
+}
+
+TestResult SerialTest::executeWith(const BitSequence& data, const PatternHistogram& histogram) {
     // Ensure we have enough data
-    if (data.size() < blockLength) {
+    if (data.size() < blockLength || blockLength > PatternHistogram::MaxOrder) {
+        TestResult result;
+        result.testName = getName();
         result.p_value = 0.0;
         result.success = false;
         result.statistics["error"] = 1.0;
         return result;
     }
+    if (histogram.order() < blockLength || histogram.sequenceLength() != data.size()) {
+        throw std::runtime_error("Serial test needs a pattern histogram of the sequence of order " +
+                                 std::to_string(blockLength));
+    }
     
-    // Calculate psi-squared statistics
-    double psim0 = psi2(data, blockLength);
-    double psim1 = psi2(data, blockLength - 1);
-    double psim2 = psi2(data, blockLength - 2);
+    // Calculate psi-squared statistics; m-1 and m-2 are marginals of the
+    // m-bit counts, so the sequence is scanned once
+    double psim0 = psi2(histogram, blockLength);
+    double psim1 = psi2(histogram, blockLength - 1);
+    double psim2 = psi2(histogram, blockLength - 2);
+
+    TestResult result = evaluate(blockLength, psim0, psim1, psim2);
+    result.testName = getName();
+    return result;
+}
+
+TestResult SerialTest::evaluate(size_t m, double psim0, double psim1, double psim2) {
+    TestResult result;
     
     // Calculate deltas
     double del1 = psim0 - psim1;
     double del2 = psim0 - 2.0 * psim1 + psim2;
     
     // Calculate p-values
-    double p_value1 = igamc(std::pow(2, blockLength - 1) / 2.0, del1 / 2.0);
-    double p_value2 = igamc(std::pow(2, blockLength - 2) / 2.0, del2 / 2.0);
+    double p_value1 = igamc(std::pow(2, m - 1) / 2.0, del1 / 2.0);
+    double p_value2 = igamc(std::pow(2, m - 2) / 2.0, del2 / 2.0);
     
     // Store results
     result.statistics["psi_m"] = psim0;
@@ -47,34 +67,28 @@ TestResult SerialTest::execute(const BitSequence& data) {
     
     // Use the minimum p-value as the test result
     result.p_value = std::min(p_value1, p_value2);
-    result.success = isSuccess(result.p_value);
+    result.success = (result.p_value >= ALPHA);
     
     return result;
 }
 
-double SerialTest::psi2(const BitSequence& data, size_t m) {
+double SerialTest::psi2(const PatternHistogram& histogram, size_t m) {
     if (m == 0 || m == static_cast<size_t>(-1)) {
         return 0.0;
     }
     
-    // Count frequencies of m-bit patterns
-    std::unordered_map<std::string, int> frequencies;
-    
-    for (size_t i = 0; i < data.size(); i++) {
-        std::string pattern;
-        for (size_t j = 0; j < m; j++) {
-            pattern += data[(i + j) % data.size()] ? '1' : '0';
-        }
-        frequencies[pattern]++;
-    }
+    // Frequencies of the cyclic m-bit patterns
+    PatternHistogram lower;
+    const PatternHistogram& h = (m == histogram.order()) ? histogram : (lower = histogram.marginal(m));
     
     // Calculate psi-squared statistic
     double sum = 0.0;
-    for (const auto& pair : frequencies) {
-        sum += std::pow(pair.second, 2);
+    for (uint64_t count : h.counts()) {
+        sum += static_cast<double>(count) * static_cast<double>(count);
     }
     
-    double psi = (sum * std::pow(2, m) / static_cast<double>(data.size())) - static_cast<double>(data.size());
+    double n = static_cast<double>(h.sequenceLength());
+    double psi = (sum * std::pow(2, m) / n) - n;
     return psi;
 }
 
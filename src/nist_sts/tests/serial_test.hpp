@@ -2,6 +2,7 @@
 #pragma once
 #include "statistical_test.hpp"
 #include "bitsequence.hpp"
+#include "pattern_histogram.hpp"
 
 namespace nist_sts {
 
@@ -13,12 +14,22 @@ public:
     explicit SerialTest(size_t blockLength = 16);
     TestResult execute(const BitSequence& data) override;
     std::string getName() const override { return "Serial"; }
+
+    // psi-squared for m, m-1 and m-2 all come from the m-bit counts
+    size_t patternOrder() const override {
+        return blockLength <= PatternHistogram::MaxOrder ? blockLength : 0;
+    }
+    TestResult executeWith(const BitSequence& data, const PatternHistogram& histogram) override;
     
     void setBlockLength(size_t length) { blockLength = length; }
     size_t getBlockLength() const { return blockLength; }
+
+    // Evaluate from psi-squared statistics for m, m-1 and m-2 (shared with the
+    // streaming accumulators)
+    static TestResult evaluate(size_t m, double psim0, double psim1, double psim2);
     
 private:
-    double psi2(const BitSequence& data, size_t m);
+    static double psi2(const PatternHistogram& histogram, size_t m);
 };
 
 } // namespace nist_sts
\ No newline at end of file
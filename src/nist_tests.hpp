@@ -1,9 +1,15 @@
 // nist_tests.hpp
 #pragma once
 #include "statistical_test.hpp"
+#include "bitsequence.hpp"
+#include "bit_utils.hpp"
 #include <vector>
 #include <memory>
 #include <cmath>
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <iomanip>
 
 namespace nist_sts {
 
@@ -12,21 +18,13 @@ class FrequencyTest : public StatisticalTest {
 public:
     FrequencyTest() = default;
     
-    TestResult execute(const std::vector<uint8_t>& data) override {
+    TestResult execute(const BitSequence& data) override {
         TestResult result;
         result.testName = getName();
         
         // Count total bits and ones
-        long long totalBits = data.size() * 8LL;
-        long long onesCount = 0;
-        
-        for (auto byte : data) {
-            for (int bit = 0; bit < 8; bit++) {
-                if ((byte >> bit) & 1) {
-                    onesCount++;
-                }
-            }
-        }
+        long long totalBits = static_cast<long long>(data.size());
+        long long onesCount = static_cast<long long>(data.countOnes());
         
         // Calculate test statistic
         double proportion = static_cast<double>(onesCount) / static_cast<double>(totalBits);
@@ -53,29 +51,17 @@ class RunsTest : public StatisticalTest {
 public:
     RunsTest() = default;
     
-    TestResult execute(const std::vector<uint8_t>& data) override {
+    TestResult execute(const BitSequence& data) override {
         TestResult result;
         result.testName = getName();
         
-        // Convert to bits and count runs
-        std::vector<bool> bits;
-        bits.reserve(data.size() * 8);
-        
-        for (auto byte : data) {
-            for (int i = 7; i >= 0; i--) {
-                bits.push_back((byte >> i) & 1);
-            }
-        }
-        
         // Count ones for proportion
-        size_t ones = 0;
-        for (bool bit : bits) {
-            if (bit) ones++;
-        }
-        double pi = static_cast<double>(ones) / static_cast<double>(bits.size());
+        size_t n = data.size();
+        size_t ones = data.countOnes();
+        double pi = static_cast<double>(ones) / static_cast<double>(n);
         
         // Pre-test: check if proportion is suitable
-        if (std::abs(pi - 0.5) > (2.0 / std::sqrt(bits.size()))) {
+        if (std::abs(pi - 0.5) > (2.0 / std::sqrt(n))) {
             result.p_value = 0.0;
             result.success = false;
             result.statistics["proportion"] = pi;
@@ -83,18 +69,18 @@ public:
             return result;
         }
         
-        // Count runs
+        // Count runs over 64-bit windows that overlap by one bit
         size_t runs = 1; // Start with 1 run
-        for (size_t i = 1; i < bits.size(); i++) {
-            if (bits[i] != bits[i-1]) {
-                runs++;
-            }
+        for (size_t k = 0; k + 1 < n; k += 63) {
+            unsigned count = static_cast<unsigned>(std::min<size_t>(64, n - k));
+            uint64_t w = data.getBits(k, count);
+            runs += popcount64((w ^ (w >> 1)) & ((1ULL << (count - 1)) - 1));
         }
         
         // Calculate test statistic
         double r_obs = static_cast<double>(runs);
-        double mean = 2.0 * bits.size() * pi * (1.0 - pi);
-        double std_dev = std::sqrt(2.0 * bits.size() * pi * (1.0 - pi));
+        double mean = 2.0 * n * pi * (1.0 - pi);
+        double std_dev = std::sqrt(2.0 * n * pi * (1.0 - pi));
         double z = std::abs(r_obs - mean) / std_dev;
         double p_value = std::erfc(z / std::sqrt(2.0));
         
@@ -118,41 +104,26 @@ class BlockFrequencyTest : public StatisticalTest {
 public:
     BlockFrequencyTest(size_t blockSize = 128) : blockSize(blockSize) {}
     
-    TestResult execute(const std::vector<uint8_t>& data) override {
+    TestResult execute(const BitSequence& data) override {
         TestResult result;
         result.testName = getName();
         
         // Check if we have enough data
-        if (data.size() * 8 < blockSize) {
+        if (data.size() < blockSize) {
             result.p_value = 0.0;
             result.success = false;
             result.statistics["error"] = 1.0;
             return result;
         }
         
-        // Convert to bits
-        std::vector<bool> bits;
-        bits.reserve(data.size() * 8);
-        
-        for (auto byte : data) {
-            for (int i = 7; i >= 0; i--) {
-                bits.push_back((byte >> i) & 1);
-            }
-        }
-        
         // Number of complete blocks
-        size_t numBlocks = bits.size() / blockSize;
+        size_t numBlocks = data.size() / blockSize;
         
         // Process each block
         double chi_squared = 0.0;
         for (size_t block = 0; block < numBlocks; block++) {
             // Count ones in this block
-            size_t ones = 0;
-            for (size_t i = 0; i < blockSize; i++) {
-                if (bits[block * blockSize + i]) {
-                    ones++;
-                }
-            }
+            size_t ones = data.countOnes(block * blockSize, blockSize);
             
             // Calculate proportion and contribution to chi-squared
             double pi = static_cast<double>(ones) / static_cast<double>(blockSize);
@@ -185,18 +156,14 @@ class DFTTest : public StatisticalTest {
 public:
     DFTTest() = default;
     
-    TestResult execute(const std::vector<uint8_t>& data) override {
+    TestResult execute(const BitSequence& data) override {
         TestResult result;
         result.testName = getName();
         
         // Convert to +1/-1 series
-        std::vector<double> X;
-        X.reserve(data.size() * 8);
-        
-        for (auto byte : data) {
-            for (int i = 7; i >= 0; i--) {
-                X.push_back(((byte >> i) & 1) ? 1.0 : -1.0);
-            }
+        std::vector<double> X(data.size());
+        for (size_t i = 0; i < X.size(); i++) {
+            X[i] = data[i] ? 1.0 : -1.0;
         }
         
         // Perform DFT (simple implementation)
@@ -257,8 +224,9 @@ public:
         // Add more tests as needed
     }
     
-    // Run all tests and return results
-    std::vector<TestResult> runTests(const std::vector<uint8_t>& data) {
+    // Run all tests and return results. Every test reads the same bits;
+    // nothing is re-decoded or copied per test.
+    std::vector<TestResult> runTests(const BitSequence& data) {
         std::vector<TestResult> results;
         results.reserve(tests.size());
         
@@ -269,12 +237,16 @@ public:
         return results;
     }
     
+    // Raw bytes are viewed in place, not copied
+    std::vector<TestResult> runTests(const ByteSpan& data) {
+        return runTests(BitSequence::view(data));
+    }
+    
     // Get a map of test names to p-values
-    std::map<std::string, double> getPValues(const std::vector<uint8_t>& data) {
+    std::map<std::string, double> getPValues(const ByteSpan& data) {
         std::map<std::string, double> pValues;
         
-        for (const auto& test : tests) {
-            auto result = test->execute(data);
+        for (const auto& result : runTests(data)) {
             pValues[result.testName] = result.p_value;
         }
         
@@ -282,7 +254,7 @@ public:
     }
     
     // Generate a summary report
-    std::string generateSummary(const std::vector<uint8_t>& data) {
+    std::string generateSummary(const ByteSpan& data) {
         auto results = runTests(data);
         std::stringstream ss;
         
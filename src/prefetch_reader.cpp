@@ -0,0 +1,124 @@
+// prefetch_reader.cpp
+#include "prefetch_reader.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+
+void PrefetchReader::AlignedDelete::operator()(uint8_t* p) const {
+    ::operator delete[](p, std::align_val_t(BufferAlignment));
+}
+
+PrefetchReader::PrefetchReader(const std::string& filename, size_t chunkBytes, size_t depth)
+    : chunkBytes(chunkBytes), ring(std::max<size_t>(depth, 2)) {
+    if (chunkBytes == 0) {
+        throw std::runtime_error("Prefetch chunk size must be positive");
+    }
+    for (auto& slot : ring) {
+        slot.data.reset(static_cast<uint8_t*>(
+            ::operator new[](chunkBytes, std::align_val_t(BufferAlignment))));
+    }
+
+    // Open here so a missing file is reported to the caller directly
+    std::ifstream probe(filename, std::ios::binary);
+    if (!probe) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    probe.close();
+
+    worker = std::thread(&PrefetchReader::fill, this, filename);
+}
+
+PrefetchReader::~PrefetchReader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    slotFreed.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+void PrefetchReader::fill(const std::string& filename) {
+    try {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Cannot open file: " + filename);
+        }
+        while (true) {
+            size_t slot;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                slotFreed.wait(lock, [&] { return stopping || filled < ring.size(); });
+                if (stopping) return;
+                slot = head;
+            }
+
+            // The slot is free, so the consumer does not touch it meanwhile
+            file.read(reinterpret_cast<char*>(ring[slot].data.get()),
+                      static_cast<std::streamsize>(chunkBytes));
+            size_t got = static_cast<size_t>(file.gcount());
+            if (got < chunkBytes && file.bad()) {
+                throw std::runtime_error("Read error in file: " + filename);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (got > 0) {
+                    ring[slot].size = got;
+                    head = (head + 1) % ring.size();
+                    filled++;
+                }
+                finished = got < chunkBytes;
+            }
+            slotFilled.notify_one();
+            if (got < chunkBytes) return;
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        error = std::current_exception();
+        finished = true;
+        slotFilled.notify_one();
+    }
+}
+
+void PrefetchReader::releaseCurrent() {
+    if (!holding) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        filled--;
+        holding = false;
+    }
+    current = ByteSpan();
+    currentOffset = 0;
+    slotFreed.notify_one();
+}
+
+ByteSpan PrefetchReader::next() {
+    releaseCurrent();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    slotFilled.wait(lock, [&] { return filled > 0 || finished; });
+    if (filled == 0) {
+        if (error) std::rethrow_exception(error);
+        return ByteSpan();
+    }
+    const Slot& slot = ring[tail];
+    tail = (tail + 1) % ring.size();
+    holding = true;
+    current = ByteSpan(slot.data.get(), slot.size);
+    currentOffset = 0;
+    return current;
+}
+
+size_t PrefetchReader::read(uint8_t* dest, size_t count) {
+    size_t copied = 0;
+    while (copied < count) {
+        if (currentOffset == current.size() && next().empty()) break;
+        size_t take = std::min(count - copied, current.size() - currentOffset);
+        std::memcpy(dest + copied, current.data() + currentOffset, take);
+        currentOffset += take;
+        copied += take;
+    }
+    return copied;
+}
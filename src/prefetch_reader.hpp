@@ -0,0 +1,69 @@
+// prefetch_reader.hpp
+#pragma once
+#include "byte_span.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Sequential file reader that keeps a background thread `depth` chunks ahead
+// of the consumer. Chunks are read into page-aligned buffers that cycle
+// through a bounded ring, so reading the next chunk overlaps with whatever
+// the consumer does with the current one and memory stays at
+// depth * chunkBytes. Read errors are rethrown to the consumer.
+class PrefetchReader {
+public:
+    static constexpr size_t BufferAlignment = 4096;
+
+    PrefetchReader(const std::string& filename, size_t chunkBytes, size_t depth = 3);
+    ~PrefetchReader();
+
+    PrefetchReader(const PrefetchReader&) = delete;
+    PrefetchReader& operator=(const PrefetchReader&) = delete;
+
+    // Next chunk in file order, empty at end of file. The span stays valid
+    // until the following call to next() or read().
+    ByteSpan next();
+
+    // Copy up to `count` bytes into `dest`, like std::istream::read();
+    // returns the number copied, short only at end of file
+    size_t read(uint8_t* dest, size_t count);
+
+private:
+    struct AlignedDelete {
+        void operator()(uint8_t* p) const;
+    };
+
+    struct Slot {
+        std::unique_ptr<uint8_t[], AlignedDelete> data;
+        size_t size = 0;
+    };
+
+    void fill(const std::string& filename);
+    void releaseCurrent();
+
+    size_t chunkBytes;
+    std::vector<Slot> ring;
+
+    std::mutex mutex;
+    std::condition_variable slotFilled;
+    std::condition_variable slotFreed;
+    size_t head = 0;      // next slot the reader fills
+    size_t tail = 0;      // next slot the consumer takes
+    size_t filled = 0;    // slots filled or held by the consumer
+    bool finished = false;
+    bool stopping = false;
+    std::exception_ptr error;
+
+    // Chunk handed out by next(), and how much of it read() has consumed
+    bool holding = false;
+    ByteSpan current;
+    size_t currentOffset = 0;
+
+    std::thread worker;
+};
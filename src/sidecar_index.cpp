@@ -0,0 +1,344 @@
+// sidecar_index.cpp
+#include "sidecar_index.hpp"
+#include "bitsequence.hpp"
+#include "bit_utils.hpp"
+#include "frequency_test.hpp"
+#include "block_frequency_test.hpp"
+#include "cumulative_sums_test.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+constexpr char IndexMagic[8] = {'C', 'A', 'C', 'A', 'I', 'D', 'X', '\0'};
+constexpr uint32_t IndexVersion = 1;
+
+template <typename T>
+void writeValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T readValue(std::ifstream& in) {
+    T value{};
+    if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+        throw std::runtime_error("Truncated sidecar index");
+    }
+    return value;
+}
+
+int64_t modificationTime(const std::string& filename) {
+    return static_cast<int64_t>(
+        std::filesystem::last_write_time(filename).time_since_epoch().count());
+}
+
+uint64_t rotateLeft(uint64_t x, unsigned r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+} // namespace
+
+SidecarIndex SidecarIndex::build(const ByteSpan& data, size_t blockBits) {
+    if (blockBits < 8 || blockBits > 128 || (blockBits & (blockBits - 1)) != 0) {
+        throw std::runtime_error("Index block size must be a power of two between 8 and 128 bits");
+    }
+
+    SidecarIndex index;
+    index.bytes = data.size();
+    index.blockLength = blockBits;
+    index.hash = hashContent(data);
+
+    const size_t blockBytes = blockBits / 8;
+    index.blockOnes.resize(data.size() / blockBytes);
+    for (size_t b = 0; b < index.blockOnes.size(); b++) {
+        unsigned ones = 0;
+        for (size_t i = b * blockBytes; i < (b + 1) * blockBytes; i++) {
+            ones += popcount64(data[i]);
+        }
+        index.blockOnes[b] = static_cast<uint8_t>(ones);
+    }
+
+    const ByteWalkTable& walk = byteWalkTable();
+    for (size_t start = 0; start < data.size(); start += SegmentBytes) {
+        ByteSpan chunk = data.subspan(start, SegmentBytes);
+        Segment segment;
+        long long partialSum = 0;
+        for (uint8_t b : chunk) {
+            segment.ones += popcount64(b);
+            segment.walkMax = std::max<int64_t>(segment.walkMax, partialSum + walk.prefixMax[b]);
+            segment.walkMin = std::min<int64_t>(segment.walkMin, partialSum + walk.prefixMin[b]);
+            partialSum += walk.delta[b];
+        }
+        segment.stats.add(chunk);
+        index.totalOnes += segment.ones;
+        index.segments.push_back(segment);
+    }
+    return index;
+}
+
+SidecarIndex SidecarIndex::openOrBuild(const std::string& dataFile, const ByteSpan& data,
+                                       size_t blockBits) {
+    const std::string path = sidecarPath(dataFile);
+    int64_t sourceTime = 0;
+    try {
+        sourceTime = modificationTime(dataFile);
+    } catch (const std::exception&) {
+        // Without a timestamp the sidecar can be neither trusted nor tagged
+        return build(data, blockBits);
+    }
+
+    try {
+        if (std::filesystem::exists(path)) {
+            SidecarIndex index = load(path);
+            if (index.bytes == data.size() && index.sourceTime == sourceTime &&
+                index.blockLength == blockBits) {
+                return index;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: rebuilding " << path << ": " << e.what() << "\n";
+    }
+
+    SidecarIndex index = build(data, blockBits);
+    index.sourceTime = sourceTime;
+    try {
+        index.save(path);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: " << e.what() << "\n";
+    }
+    return index;
+}
+
+void SidecarIndex::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot write sidecar index: " + path);
+    }
+
+    out.write(IndexMagic, sizeof(IndexMagic));
+    writeValue<uint32_t>(out, IndexVersion);
+    writeValue<uint32_t>(out, static_cast<uint32_t>(blockLength));
+    writeValue<uint64_t>(out, bytes);
+    writeValue<uint64_t>(out, hash);
+    writeValue<int64_t>(out, sourceTime);
+    writeValue<uint64_t>(out, SegmentBytes);
+    writeValue<uint64_t>(out, blockOnes.size());
+    writeValue<uint64_t>(out, segments.size());
+
+    out.write(reinterpret_cast<const char*>(blockOnes.data()),
+              static_cast<std::streamsize>(blockOnes.size()));
+    for (const Segment& s : segments) {
+        writeValue(out, s.ones);
+        writeValue(out, s.walkMax);
+        writeValue(out, s.walkMin);
+        out.write(reinterpret_cast<const char*>(s.stats.histogram.data()),
+                  static_cast<std::streamsize>(sizeof(s.stats.histogram)));
+        writeValue(out, s.stats.count);
+        writeValue(out, s.stats.sum);
+        writeValue(out, s.stats.sumSquares);
+        writeValue(out, s.stats.lagProducts);
+        writeValue(out, s.stats.first);
+        writeValue(out, s.stats.last);
+    }
+
+    if (!out) {
+        throw std::runtime_error("Cannot write sidecar index: " + path);
+    }
+}
+
+SidecarIndex SidecarIndex::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open sidecar index: " + path);
+    }
+
+    char magic[sizeof(IndexMagic)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, IndexMagic, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a sidecar index: " + path);
+    }
+    if (readValue<uint32_t>(in) != IndexVersion) {
+        throw std::runtime_error("Unsupported sidecar index version: " + path);
+    }
+
+    SidecarIndex index;
+    index.blockLength = readValue<uint32_t>(in);
+    index.bytes = readValue<uint64_t>(in);
+    index.hash = readValue<uint64_t>(in);
+    index.sourceTime = readValue<int64_t>(in);
+    uint64_t segmentBytes = readValue<uint64_t>(in);
+    uint64_t blockCount = readValue<uint64_t>(in);
+    uint64_t segmentCount = readValue<uint64_t>(in);
+
+    if (segmentBytes != SegmentBytes || index.blockLength < 8 || index.blockLength > 128 ||
+        (index.blockLength & (index.blockLength - 1)) != 0 ||
+        blockCount != index.bytes / (index.blockLength / 8) ||
+        segmentCount != (index.bytes + SegmentBytes - 1) / SegmentBytes) {
+        throw std::runtime_error("Corrupt sidecar index: " + path);
+    }
+
+    index.blockOnes.resize(blockCount);
+    if (!in.read(reinterpret_cast<char*>(index.blockOnes.data()),
+                 static_cast<std::streamsize>(blockCount))) {
+        throw std::runtime_error("Truncated sidecar index");
+    }
+    index.segments.resize(segmentCount);
+    for (Segment& s : index.segments) {
+        s.ones = readValue<uint64_t>(in);
+        s.walkMax = readValue<int64_t>(in);
+        s.walkMin = readValue<int64_t>(in);
+        if (!in.read(reinterpret_cast<char*>(s.stats.histogram.data()),
+                     static_cast<std::streamsize>(sizeof(s.stats.histogram)))) {
+            throw std::runtime_error("Truncated sidecar index");
+        }
+        s.stats.count = readValue<uint64_t>(in);
+        s.stats.sum = readValue<uint64_t>(in);
+        s.stats.sumSquares = readValue<uint64_t>(in);
+        s.stats.lagProducts = readValue<uint64_t>(in);
+        s.stats.first = readValue<uint8_t>(in);
+        s.stats.last = readValue<uint8_t>(in);
+        index.totalOnes += s.ones;
+    }
+    index.loaded = true;
+    return index;
+}
+
+// 64-bit multiply-rotate hash over 8-byte words; not cryptographic, only
+// meant to notice a file that changed under an unchanged timestamp
+uint64_t SidecarIndex::hashContent(const ByteSpan& data) {
+    const uint64_t k1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t k2 = 0xC2B2AE3D27D4EB4FULL;
+    uint64_t h = k2 ^ (data.size() * k1);
+
+    size_t i = 0;
+    for (; i + 8 <= data.size(); i += 8) {
+        uint64_t w;
+        std::memcpy(&w, data.data() + i, sizeof(w));
+        h = rotateLeft(h ^ (w * k1), 31) * k2;
+    }
+    uint64_t tail = 0;
+    for (size_t k = 0; i + k < data.size(); k++) {
+        tail |= static_cast<uint64_t>(data[i + k]) << (8 * k);
+    }
+    h = rotateLeft(h ^ (tail * k1), 31) * k2;
+
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return h;
+}
+
+bool SidecarIndex::matches(const ByteSpan& data) const {
+    return data.size() == bytes && hashContent(data) == hash;
+}
+
+size_t SidecarIndex::countOnes(size_t pos, size_t length, const ByteSpan& data) const {
+    const size_t n = bitCount();
+    if (pos > n) pos = n;
+    if (length > n - pos) length = n - pos;
+    const size_t end = pos + length;
+
+    const nist_sts::BitSequence bits = nist_sts::BitSequence::view(data.subspan(0, bytes));
+    size_t firstBlock = (pos + blockLength - 1) / blockLength;
+    size_t lastBlock = std::min(end / blockLength, blockOnes.size());
+    if (firstBlock >= lastBlock) {
+        return bits.countOnes(pos, length);
+    }
+
+    size_t ones = bits.countOnes(pos, firstBlock * blockLength - pos);
+    ones += bits.countOnes(lastBlock * blockLength, end - lastBlock * blockLength);
+
+    // Whole blocks, with whole segments taken from the segment totals
+    const size_t blocksPerSegment = SegmentBytes * 8 / blockLength;
+    size_t b = firstBlock;
+    while (b < lastBlock) {
+        if (b % blocksPerSegment == 0 && b + blocksPerSegment <= lastBlock) {
+            ones += segments[b / blocksPerSegment].ones;
+            b += blocksPerSegment;
+        } else {
+            ones += blockOnes[b++];
+        }
+    }
+    return ones;
+}
+
+long long SidecarIndex::partialSum(size_t block) const {
+    if (block >= blockOnes.size()) {
+        throw std::runtime_error("Block index out of range");
+    }
+    const size_t blocksPerSegment = SegmentBytes * 8 / blockLength;
+    const size_t end = block + 1;
+
+    long long ones = 0;
+    size_t b = 0;
+    for (; b + blocksPerSegment <= end; b += blocksPerSegment) {
+        ones += static_cast<long long>(segments[b / blocksPerSegment].ones);
+    }
+    for (; b < end; b++) {
+        ones += blockOnes[b];
+    }
+    return 2 * ones - static_cast<long long>(end * blockLength);
+}
+
+ByteStats SidecarIndex::byteStats() const {
+    ByteStats stats;
+    for (const Segment& s : segments) {
+        stats.merge(s.stats);
+    }
+    return stats;
+}
+
+nist_sts::TestResult SidecarIndex::frequency() const {
+    nist_sts::TestResult result = nist_sts::FrequencyTest::evaluate(totalOnes, bitCount());
+    result.testName = "Frequency";
+    return result;
+}
+
+nist_sts::TestResult SidecarIndex::blockFrequency(size_t length) const {
+    if (length == 0 || length % blockLength != 0) {
+        throw std::runtime_error("Block Frequency length must be a multiple of the index block size (" +
+                                 std::to_string(blockLength) + " bits)");
+    }
+
+    const size_t n = bitCount();
+    if (n < length) {
+        nist_sts::TestResult result;
+        result.testName = "Block Frequency";
+        result.statistics["error"] = 1.0;
+        return result;
+    }
+
+    // Same accumulation order as BlockFrequencyTest::execute()
+    const size_t perBlock = length / blockLength;
+    const size_t N = n / length;
+    double sum = 0.0;
+    for (size_t i = 0; i < N; i++) {
+        size_t blockSum = 0;
+        for (size_t b = i * perBlock; b < (i + 1) * perBlock; b++) {
+            blockSum += blockOnes[b];
+        }
+        double pi = static_cast<double>(blockSum) / length;
+        double v = pi - 0.5;
+        sum += v * v;
+    }
+    return nist_sts::BlockFrequencyTest::evaluate(n, length, sum);
+}
+
+nist_sts::TestResult SidecarIndex::cumulativeSums() const {
+    long long partialSum = 0;
+    long long maxSum = 0;
+    long long minSum = 0;
+    for (const Segment& s : segments) {
+        maxSum = std::max(maxSum, partialSum + s.walkMax);
+        minSum = std::min(minSum, partialSum + s.walkMin);
+        partialSum += 2 * static_cast<long long>(s.ones) - static_cast<long long>(8 * s.stats.count);
+    }
+    long long z = std::max(maxSum, -minSum);
+    long long zRev = std::max(partialSum - minSum, maxSum - partialSum);
+    nist_sts::TestResult result = nist_sts::CumulativeSumsTest::evaluate(bitCount(), z, zRev);
+    result.testName = "Cumulative Sums";
+    return result;
+}
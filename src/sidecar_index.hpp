@@ -0,0 +1,85 @@
+// sidecar_index.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "byte_span.hpp"
+#include "byte_stats.hpp"
+#include "common.hpp"
+
+// Persistent summary of a binary capture, saved next to it as
+// <file>.cacaidx so repeated analyses of the same file can skip rescanning.
+//
+// The data is summarized at two granularities: a popcount for every block of
+// blockBits bits (default 128, the Block Frequency default), and for every
+// 1 MiB segment its popcount, the extremes of the +/-1 walk within it and
+// mergeable byte statistics. Frequency, Block Frequency (any multiple of
+// blockBits), Cumulative Sums and the byte statistics are answered from these
+// in O(blocks); countOnes() over an arbitrary bit window only reads the raw
+// bits of the partial blocks at its ends.
+//
+// A saved index is reused when the file's size and modification time are
+// unchanged; the content hash can be checked with matches() when that is not
+// trusted enough.
+class SidecarIndex {
+public:
+    static constexpr size_t DefaultBlockBits = 128;
+    static constexpr size_t SegmentBytes = size_t(1) << 20;
+
+    SidecarIndex() = default;
+
+    // Summarize `data`; blockBits must be a power of two between 8 and 128
+    static SidecarIndex build(const ByteSpan& data, size_t blockBits = DefaultBlockBits);
+
+    static std::string sidecarPath(const std::string& dataFile) { return dataFile + ".cacaidx"; }
+
+    // Load the sidecar of `dataFile` if it is current, otherwise build it
+    // from `data` (the file's contents) and try to save it
+    static SidecarIndex openOrBuild(const std::string& dataFile, const ByteSpan& data,
+                                    size_t blockBits = DefaultBlockBits);
+
+    // Load a saved index; throws std::runtime_error if it is unreadable
+    static SidecarIndex load(const std::string& path);
+    void save(const std::string& path) const;
+
+    static uint64_t hashContent(const ByteSpan& data);
+    bool matches(const ByteSpan& data) const;
+
+    size_t byteCount() const { return bytes; }
+    size_t bitCount() const { return bytes * 8; }
+    size_t blockBits() const { return blockLength; }
+    uint64_t contentHash() const { return hash; }
+    bool wasLoaded() const { return loaded; }
+
+    // Ones in bits [pos, pos + length); `data` supplies the partial blocks
+    size_t countOnes(size_t pos, size_t length, const ByteSpan& data) const;
+    size_t countOnes() const { return totalOnes; }
+
+    // Walk value S_k = 2 * ones(0, k) - k at the end of block `block`
+    long long partialSum(size_t block) const;
+
+    ByteStats byteStats() const;
+
+    nist_sts::TestResult frequency() const;
+    nist_sts::TestResult blockFrequency(size_t blockLength = DefaultBlockBits) const;
+    nist_sts::TestResult cumulativeSums() const;
+
+private:
+    struct Segment {
+        uint64_t ones = 0;
+        int64_t walkMax = 0;  // walk extremes relative to the segment start
+        int64_t walkMin = 0;
+        ByteStats stats;
+    };
+
+    size_t bytes = 0;
+    size_t blockLength = DefaultBlockBits;
+    uint64_t hash = 0;
+    int64_t sourceTime = 0;  // data file modification time when built
+    size_t totalOnes = 0;
+    bool loaded = false;
+
+    std::vector<uint8_t> blockOnes;  // one count per whole block
+    std::vector<Segment> segments;
+};
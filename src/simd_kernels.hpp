@@ -0,0 +1,93 @@
+// simd_kernels.hpp
+#pragma once
+#include "cpu_features.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// Entry points of the per-ISA kernel units (simd_kernels_sse2.cpp,
+// simd_kernels_avx2.cpp, simd_kernels_avx512.cpp). Each unit is compiled
+// with its own instruction-set flags, so its kernels may only be called when
+// simdLevel() is at least that level. A unit compiled without its flags
+// (another architecture, or a build that skips them) contains stubs and
+// reports itself missing, so detection never selects it.
+//
+// Kernels process whole vectors starting at `first` and return the index
+// where they stopped; the caller finishes the rest with its scalar code.
+namespace simd_kernels {
+
+// Whether each unit was compiled with its instruction set
+bool builtSse2();
+bool builtAvx2();
+bool builtAvx512();
+
+// One elementary generation of in[first, last) into out under Wolfram rule
+// `rule`; in[first - 1] and in[last] are read as neighbours
+size_t elementarySse2(const uint64_t* in, uint64_t* out, size_t first, size_t last, uint8_t rule);
+size_t elementaryAvx2(const uint64_t* in, uint64_t* out, size_t first, size_t last, uint8_t rule);
+size_t elementaryAvx512(const uint64_t* in, uint64_t* out, size_t first, size_t last, uint8_t rule);
+
+// Cycle-detection fingerprint of words[first, last), word i keyed by
+// i + offset, added to sum and mix (ca_kernels.hpp)
+size_t fingerprintSse2(const uint64_t* words, size_t first, size_t last, uint64_t offset,
+                       uint64_t& sum, uint64_t& mix);
+size_t fingerprintAvx2(const uint64_t* words, size_t first, size_t last, uint64_t offset,
+                       uint64_t& sum, uint64_t& mix);
+size_t fingerprintAvx512(const uint64_t* words, size_t first, size_t last, uint64_t offset,
+                         uint64_t& sum, uint64_t& mix);
+
+// The two passes of a Moore-neighbourhood generation (ca_kernels.hpp)
+struct MooreRuleWords;
+
+size_t mooreColumnsSse2(const uint64_t* up, const uint64_t* centre, const uint64_t* down,
+                        uint64_t* a0, uint64_t* a1, size_t first, size_t last);
+size_t mooreColumnsAvx2(const uint64_t* up, const uint64_t* centre, const uint64_t* down,
+                        uint64_t* a0, uint64_t* a1, size_t first, size_t last);
+size_t mooreColumnsAvx512(const uint64_t* up, const uint64_t* centre, const uint64_t* down,
+                          uint64_t* a0, uint64_t* a1, size_t first, size_t last);
+
+size_t mooreRuleSse2(const uint64_t* a0, const uint64_t* a1, const uint64_t* centre,
+                     uint64_t* out, size_t first, size_t last, const MooreRuleWords& rule);
+size_t mooreRuleAvx2(const uint64_t* a0, const uint64_t* a1, const uint64_t* centre,
+                     uint64_t* out, size_t first, size_t last, const MooreRuleWords& rule);
+size_t mooreRuleAvx512(const uint64_t* a0, const uint64_t* a1, const uint64_t* centre,
+                       uint64_t* out, size_t first, size_t last, const MooreRuleWords& rule);
+
+// Adaptive median of the denoiser's 3x3 windows over bytes [first, last) of
+// a row (median_kernels.hpp). There is no AVX-512 version: byte min/max on
+// ZMM registers needs AVX-512BW, which the AVX-512 unit does not assume.
+size_t medianRowSse2(const uint8_t* up, const uint8_t* centre, const uint8_t* down, uint8_t* out,
+                     size_t first, size_t last, bool& pending);
+size_t medianRowAvx2(const uint8_t* up, const uint8_t* centre, const uint8_t* down, uint8_t* out,
+                     size_t first, size_t last, bool& pending);
+
+// Image-quality metrics (image_metrics.hpp, metric_kernels.hpp): the sum of
+// squared differences of a[first, last) and b[first, last) added to `sum`,
+// and one row slid through the SSIM window's five column sums. No AVX-512
+// versions, for the same reason as above (pmaddwd on ZMM needs AVX-512BW).
+size_t squaredErrorSse2(const uint8_t* a, const uint8_t* b, size_t first, size_t last, uint64_t& sum);
+size_t squaredErrorAvx2(const uint8_t* a, const uint8_t* b, size_t first, size_t last, uint64_t& sum);
+size_t slideMomentsSse2(const uint8_t* xIn, const uint8_t* yIn, const uint8_t* xOut, const uint8_t* yOut,
+                        uint32_t* moments, size_t stride, size_t first, size_t last);
+size_t slideMomentsAvx2(const uint8_t* xIn, const uint8_t* yIn, const uint8_t* xOut, const uint8_t* yOut,
+                        uint32_t* moments, size_t stride, size_t first, size_t last);
+
+// Running median of a byte filter (byte_filter.hpp): out[i] = median of
+// padded[i, i + window) for i in [first, last), window odd and at most 255
+size_t runningMedianSse2(const uint8_t* padded, uint8_t* out, size_t first, size_t last, size_t window);
+
+// Adds the number of set bits in the 8-byte words [first, last) of `data` to
+// `ones` (byte order does not matter)
+size_t popcountAvx2(const uint8_t* data, size_t first, size_t last, uint64_t& ones);
+
+// Text decoders (input_decoders.hpp): blocks of text[first, last), 16
+// characters for SSE2 and 32 for AVX2, are decoded to out + bytes, advancing
+// `bytes`, until a block holds anything but valid symbols (whitespace
+// included) or too few characters remain
+size_t asciiBitsSse2(const uint8_t* text, uint8_t* out, size_t first, size_t last, size_t& bytes);
+size_t hexSse2(const uint8_t* text, uint8_t* out, size_t first, size_t last, size_t& bytes);
+size_t base64Sse2(const uint8_t* text, uint8_t* out, size_t first, size_t last, size_t& bytes);
+size_t asciiBitsAvx2(const uint8_t* text, uint8_t* out, size_t first, size_t last, size_t& bytes);
+size_t hexAvx2(const uint8_t* text, uint8_t* out, size_t first, size_t last, size_t& bytes);
+size_t base64Avx2(const uint8_t* text, uint8_t* out, size_t first, size_t last, size_t& bytes);
+
+} // namespace simd_kernels
@@ -0,0 +1,305 @@
+// simd_kernels_avx2.cpp
+// AVX2 kernels; CMakeLists.txt compiles this unit with AVX2 and POPCNT enabled.
+#include "ca_kernels.hpp"
+#include "median_kernels.hpp"
+#include "metric_kernels.hpp"
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+namespace simd_kernels {
+
+namespace {
+
+struct Avx2Ops {
+    using V = __m256i;
+    static constexpr size_t Lanes = 4;
+    static V load(const uint64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(uint64_t* p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static V set1(uint64_t x) { return _mm256_set1_epi64x(static_cast<long long>(x)); }
+    static V andV(V a, V b) { return _mm256_and_si256(a, b); }
+    static V orV(V a, V b) { return _mm256_or_si256(a, b); }
+    static V xorV(V a, V b) { return _mm256_xor_si256(a, b); }
+    static V andNot(V a, V b) { return _mm256_andnot_si256(a, b); }
+    static V shr1(V a) { return _mm256_srli_epi64(a, 1); }
+    static V shl1(V a) { return _mm256_slli_epi64(a, 1); }
+    static V shr63(V a) { return _mm256_srli_epi64(a, 63); }
+    static V shl63(V a) { return _mm256_slli_epi64(a, 63); }
+    static V shr32(V a) { return _mm256_srli_epi64(a, 32); }
+    static V add64(V a, V b) { return _mm256_add_epi64(a, b); }
+    static V mulLow32(V a, V b) { return _mm256_mul_epu32(a, b); }
+};
+
+struct Avx2ByteOps {
+    using V = __m256i;
+    static constexpr size_t Lanes = 32;
+    static V load(const uint8_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(uint8_t* p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static V set1(uint8_t x) { return _mm256_set1_epi8(static_cast<char>(x)); }
+    static V andV(V a, V b) { return _mm256_and_si256(a, b); }
+    static V orV(V a, V b) { return _mm256_or_si256(a, b); }
+    static V andNot(V a, V b) { return _mm256_andnot_si256(a, b); }
+    static V minU8(V a, V b) { return _mm256_min_epu8(a, b); }
+    static V maxU8(V a, V b) { return _mm256_max_epu8(a, b); }
+    static V eqU8(V a, V b) { return _mm256_cmpeq_epi8(a, b); }
+    static V addU8(V a, V b) { return _mm256_add_epi8(a, b); }
+    static V subU8(V a, V b) { return _mm256_sub_epi8(a, b); }
+    static V halfU8(V a) { return _mm256_and_si256(_mm256_srli_epi16(a, 1), set1(0x7F)); }
+    static bool any(V a) { return _mm256_movemask_epi8(a) != 0; }
+};
+
+struct Avx2PixelOps {
+    using V = __m256i;
+    static constexpr size_t Lanes = 8;
+    static V zero() { return _mm256_setzero_si256(); }
+    static V widen(const uint8_t* p) {
+        return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+    }
+    static V absDiff(const uint8_t* a, const uint8_t* b) {
+        const __m128i va = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a));
+        const __m128i vb = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b));
+        return _mm256_cvtepu8_epi32(_mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va)));
+    }
+    static V load(const uint32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(uint32_t* p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static V add(V a, V b) { return _mm256_add_epi32(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_epi32(a, b); }
+    static V mul(V a, V b) { return _mm256_madd_epi16(a, b); }
+    static uint64_t sumLanes(V a) {
+        alignas(32) uint32_t lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), a);
+        uint64_t total = 0;
+        for (uint32_t lane : lanes) total += lane;
+        return total;
+    }
+};
+
+// Each block function decodes 32 characters if they are all valid symbols
+// (no whitespace) and returns false otherwise, leaving the output untouched.
+
+bool asciiBitsBlock(const uint8_t* in, uint8_t* out) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+    __m256i valid = _mm256_cmpeq_epi8(_mm256_andnot_si256(_mm256_set1_epi8(1), v),
+                                      _mm256_set1_epi8('0'));
+    if (_mm256_movemask_epi8(valid) != -1) return false;
+
+    // Reverse each group of 8 so the first character lands in the top bit,
+    // then move every character's low bit into the sign bit
+    const __m256i reverse8 = _mm256_setr_epi8(
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    v = _mm256_shuffle_epi8(v, reverse8);
+    uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_slli_epi64(v, 7)));
+    std::memcpy(out, &mask, 4);  // little-endian: byte k holds characters 8k..8k+7
+    return true;
+}
+
+bool hexBlock(const uint8_t* in, uint8_t* out) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+    __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+
+    // Signed compares also reject bytes >= 0x80
+    __m256i isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+                                       _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+    __m256i isAlpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                       _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+    if (_mm256_movemask_epi8(_mm256_or_si256(isDigit, isAlpha)) != -1) return false;
+
+    __m256i nibbles = _mm256_blendv_epi8(
+        _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10)),
+        _mm256_sub_epi8(v, _mm256_set1_epi8('0')), isDigit);
+
+    // (hi, lo) pairs -> hi * 16 + lo in 16-bit lanes, then pack to bytes
+    __m256i pairs = _mm256_maddubs_epi16(nibbles, _mm256_set1_epi16(0x0110));
+    __m256i packed = _mm256_packus_epi16(pairs, pairs);
+    packed = _mm256_permute4x64_epi64(packed, 0x08);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+    return true;
+}
+
+bool base64Block(const uint8_t* in, uint8_t* out) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi32(v, 4), _mm256_set1_epi8(0x0F));
+    __m256i lo = _mm256_and_si256(v, _mm256_set1_epi8(0x0F));
+
+    // Valid iff bit `hi` is set in the row for `lo` (hi >= 8 is never valid)
+    const __m256i rowLUT = _mm256_setr_epi8(
+        char(0xA8), char(0xF8), char(0xF8), char(0xF8), char(0xF8), char(0xF8), char(0xF8), char(0xF8),
+        char(0xF8), char(0xF8), char(0xF0), char(0x54), char(0x50), char(0x50), char(0x50), char(0x54),
+        char(0xA8), char(0xF8), char(0xF8), char(0xF8), char(0xF8), char(0xF8), char(0xF8), char(0xF8),
+        char(0xF8), char(0xF8), char(0xF0), char(0x54), char(0x50), char(0x50), char(0x50), char(0x54));
+    const __m256i columnLUT = _mm256_setr_epi8(
+        1, 2, 4, 8, 16, 32, 64, char(0x80), 0, 0, 0, 0, 0, 0, 0, 0,
+        1, 2, 4, 8, 16, 32, 64, char(0x80), 0, 0, 0, 0, 0, 0, 0, 0);
+    __m256i hit = _mm256_and_si256(_mm256_shuffle_epi8(rowLUT, lo),
+                                   _mm256_shuffle_epi8(columnLUT, hi));
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(hit, _mm256_setzero_si256())) != 0) return false;
+
+    // Character to 6-bit value: one offset per high nibble, '/' special-cased
+    const __m256i offsetLUT = _mm256_setr_epi8(
+        0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    __m256i offset = _mm256_blendv_epi8(_mm256_shuffle_epi8(offsetLUT, hi),
+                                        _mm256_set1_epi8(16),
+                                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('/')));
+    __m256i values = _mm256_add_epi8(v, offset);
+
+    // Four 6-bit values -> one 24-bit group per 32-bit lane, then drop the
+    // top byte of each lane and close the gap between the 128-bit halves
+    __m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+    const __m256i toBigEndian = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    merged = _mm256_shuffle_epi8(merged, toBigEndian);
+    merged = _mm256_permutevar8x32_epi32(merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+    alignas(32) uint8_t block[32];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(block), merged);
+    std::memcpy(out, block, 24);
+    return true;
+}
+
+} // namespace
+
+bool builtAvx2() {
+    return true;
+}
+
+size_t elementaryAvx2(const uint64_t* in, uint64_t* out, size_t first, size_t last, uint8_t rule) {
+    static constexpr auto kernels = elementaryKernels<Avx2Ops>(std::make_index_sequence<256>{});
+    return kernels[rule](in, out, first, last);
+}
+
+size_t fingerprintAvx2(const uint64_t* words, size_t first, size_t last, uint64_t offset,
+                       uint64_t& sum, uint64_t& mix) {
+    return fingerprintWords<Avx2Ops>(words, first, last, offset, sum, mix);
+}
+
+size_t mooreColumnsAvx2(const uint64_t* up, const uint64_t* centre, const uint64_t* down,
+                        uint64_t* a0, uint64_t* a1, size_t first, size_t last) {
+    return sumColumns<Avx2Ops>(up, centre, down, a0, a1, first, last);
+}
+
+size_t mooreRuleAvx2(const uint64_t* a0, const uint64_t* a1, const uint64_t* centre,
+                     uint64_t* out, size_t first, size_t last, const MooreRuleWords& rule) {
+    return applyRule<Avx2Ops>(a0, a1, centre, out, first, last, rule);
+}
+
+size_t medianRowAvx2(const uint8_t* up, const uint8_t* centre, const uint8_t* down, uint8_t* out,
+                     size_t first, size_t last, bool& pending) {
+    return medianRow<Avx2ByteOps>(up, centre, down, out, first, last, pending);
+}
+
+size_t squaredErrorAvx2(const uint8_t* a, const uint8_t* b, size_t first, size_t last, uint64_t& sum) {
+    return squaredError<Avx2PixelOps>(a, b, first, last, sum);
+}
+
+size_t slideMomentsAvx2(const uint8_t* xIn, const uint8_t* yIn, const uint8_t* xOut, const uint8_t* yOut,
+                        uint32_t* moments, size_t stride, size_t first, size_t last) {
+    return slideMoments<Avx2PixelOps>(xIn, yIn, xOut, yOut, moments, stride, first, last);
+}
+
+// Nibble lookup with vpshufb, byte counts summed into 64-bit lanes with
+// vpsadbw (Mula's method). Faster than a POPCNT loop, and the baseline
+// build has no POPCNT instruction at all.
+size_t popcountAvx2(const uint8_t* data, size_t first, size_t last, uint64_t& ones) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+    __m256i total = _mm256_setzero_si256();
+
+    size_t w = first;
+    for (; w + 4 <= last; w += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 8 * w));
+        __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, lowNibble));
+        __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibble));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+    }
+    ones += static_cast<uint64_t>(_mm256_extract_epi64(total, 0)) +
+            static_cast<uint64_t>(_mm256_extract_epi64(total, 1)) +
+            static_cast<uint64_t>(_mm256_extract_epi64(total, 2)) +
+            static_cast<uint64_t>(_mm256_extract_epi64(total, 3));
+    return w;
+}
+
+size_t asciiBitsAvx2(const uint8_t* text, uint8_t* out, size_t first, size_t last, size_t& bytes) {
+    size_t i = first;
+    for (; i + 32 <= last && asciiBitsBlock(text + i, out + bytes); i += 32) bytes += 4;
+    return i;
+}
+
+size_t hexAvx2(const uint8_t* text, uint8_t* out, size_t first, size_t last, size_t& bytes) {
+    size_t i = first;
+    for (; i + 32 <= last && hexBlock(text + i, out + bytes); i += 32) bytes += 16;
+    return i;
+}
+
+size_t base64Avx2(const uint8_t* text, uint8_t* out, size_t first, size_t last, size_t& bytes) {
+    size_t i = first;
+    for (; i + 32 <= last && base64Block(text + i, out + bytes); i += 32) bytes += 24;
+    return i;
+}
+
+} // namespace simd_kernels
+
+#else
+
+namespace simd_kernels {
+
+bool builtAvx2() {
+    return false;
+}
+
+size_t elementaryAvx2(const uint64_t*, uint64_t*, size_t first, size_t, uint8_t) {
+    return first;
+}
+
+size_t fingerprintAvx2(const uint64_t*, size_t first, size_t, uint64_t, uint64_t&, uint64_t&) {
+    return first;
+}
+
+size_t mooreColumnsAvx2(const uint64_t*, const uint64_t*, const uint64_t*,
+                        uint64_t*, uint64_t*, size_t first, size_t) {
+    return first;
+}
+
+size_t mooreRuleAvx2(const uint64_t*, const uint64_t*, const uint64_t*,
+                     uint64_t*, size_t first, size_t, const MooreRuleWords&) {
+    return first;
+}
+
+size_t medianRowAvx2(const uint8_t*, const uint8_t*, const uint8_t*, uint8_t*,
+                     size_t first, size_t, bool&) {
+    return first;
+}
+
+size_t squaredErrorAvx2(const uint8_t*, const uint8_t*, size_t first, size_t, uint64_t&) {
+    return first;
+}
+
+size_t slideMomentsAvx2(const uint8_t*, const uint8_t*, const uint8_t*, const uint8_t*,
+                        uint32_t*, size_t, size_t first, size_t) {
+    return first;
+}
+
+size_t popcountAvx2(const uint8_t*, size_t first, size_t, uint64_t&) {
+    return first;
+}
+
+size_t asciiBitsAvx2(const uint8_t*, uint8_t*, size_t first, size_t, size_t&) {
+    return first;
+}
+
+size_t hexAvx2(const uint8_t*, uint8_t*, size_t first, size_t, size_t&) {
+    return first;
+}
+
+size_t base64Avx2(const uint8_t*, uint8_t*, size_t first, size_t, size_t&) {
+    return first;
+}
+
+} // namespace simd_kernels
+
+#endif
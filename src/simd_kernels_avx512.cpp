@@ -0,0 +1,108 @@
+// simd_kernels_avx512.cpp
+// AVX-512 kernels; CMakeLists.txt compiles this unit with AVX-512F enabled.
+#include "ca_kernels.hpp"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+
+namespace simd_kernels {
+
+namespace {
+
+// vpternlogq takes the rule table as its immediate (operand order l, c, r
+// gives exactly Wolfram's bit numbering), so each rule gets its own kernel
+template <int Rule>
+size_t stepTernlog(const uint64_t* in, uint64_t* out, size_t first, size_t last) {
+    size_t w = first;
+    for (; w + 8 <= last; w += 8) {
+        __m512i c = _mm512_loadu_si512(in + w);
+        __m512i prev = _mm512_loadu_si512(in + w - 1);
+        __m512i succ = _mm512_loadu_si512(in + w + 1);
+        __m512i l = _mm512_or_si512(_mm512_srli_epi64(c, 1), _mm512_slli_epi64(prev, 63));
+        __m512i r = _mm512_or_si512(_mm512_slli_epi64(c, 1), _mm512_srli_epi64(succ, 63));
+        _mm512_storeu_si512(out + w, _mm512_ternarylogic_epi64(l, c, r, Rule));
+    }
+    return w;
+}
+
+template <size_t... Rules>
+constexpr std::array<ElementaryKernel, sizeof...(Rules)> ternlogKernels(std::index_sequence<Rules...>) {
+    return {{&stepTernlog<static_cast<int>(Rules)>...}};
+}
+
+struct Avx512Ops {
+    using V = __m512i;
+    static constexpr size_t Lanes = 8;
+    static V load(const uint64_t* p) { return _mm512_loadu_si512(p); }
+    static void store(uint64_t* p, V v) { _mm512_storeu_si512(p, v); }
+    static V set1(uint64_t x) { return _mm512_set1_epi64(static_cast<long long>(x)); }
+    static V andV(V a, V b) { return _mm512_and_si512(a, b); }
+    static V orV(V a, V b) { return _mm512_or_si512(a, b); }
+    static V xorV(V a, V b) { return _mm512_xor_si512(a, b); }
+    static V andNot(V a, V b) { return _mm512_andnot_si512(a, b); }
+    static V shr1(V a) { return _mm512_srli_epi64(a, 1); }
+    static V shl1(V a) { return _mm512_slli_epi64(a, 1); }
+    static V shr63(V a) { return _mm512_srli_epi64(a, 63); }
+    static V shl63(V a) { return _mm512_slli_epi64(a, 63); }
+    static V shr32(V a) { return _mm512_srli_epi64(a, 32); }
+    static V add64(V a, V b) { return _mm512_add_epi64(a, b); }
+    static V mulLow32(V a, V b) { return _mm512_mul_epu32(a, b); }
+};
+
+} // namespace
+
+bool builtAvx512() {
+    return true;
+}
+
+size_t elementaryAvx512(const uint64_t* in, uint64_t* out, size_t first, size_t last, uint8_t rule) {
+    static constexpr auto kernels = ternlogKernels(std::make_index_sequence<256>{});
+    return kernels[rule](in, out, first, last);
+}
+
+size_t fingerprintAvx512(const uint64_t* words, size_t first, size_t last, uint64_t offset,
+                         uint64_t& sum, uint64_t& mix) {
+    return fingerprintWords<Avx512Ops>(words, first, last, offset, sum, mix);
+}
+
+size_t mooreColumnsAvx512(const uint64_t* up, const uint64_t* centre, const uint64_t* down,
+                          uint64_t* a0, uint64_t* a1, size_t first, size_t last) {
+    return sumColumns<Avx512Ops>(up, centre, down, a0, a1, first, last);
+}
+
+size_t mooreRuleAvx512(const uint64_t* a0, const uint64_t* a1, const uint64_t* centre,
+                       uint64_t* out, size_t first, size_t last, const MooreRuleWords& rule) {
+    return applyRule<Avx512Ops>(a0, a1, centre, out, first, last, rule);
+}
+
+} // namespace simd_kernels
+
+#else
+
+namespace simd_kernels {
+
+bool builtAvx512() {
+    return false;
+}
+
+size_t elementaryAvx512(const uint64_t*, uint64_t*, size_t first, size_t, uint8_t) {
+    return first;
+}
+
+size_t fingerprintAvx512(const uint64_t*, size_t first, size_t, uint64_t, uint64_t&, uint64_t&) {
+    return first;
+}
+
+size_t mooreColumnsAvx512(const uint64_t*, const uint64_t*, const uint64_t*,
+                          uint64_t*, uint64_t*, size_t first, size_t) {
+    return first;
+}
+
+size_t mooreRuleAvx512(const uint64_t*, const uint64_t*, const uint64_t*,
+                       uint64_t*, size_t first, size_t, const MooreRuleWords&) {
+    return first;
+}
+
+} // namespace simd_kernels
+
+#endif
@@ -0,0 +1,336 @@
+// simd_kernels_sse2.cpp
+// SSE2 kernels; the x86-64 baseline, so no extra compiler flags are needed.
+#include "ca_kernels.hpp"
+#include "median_kernels.hpp"
+#include "metric_kernels.hpp"
+#include "bit_utils.hpp"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+
+namespace simd_kernels {
+
+namespace {
+
+struct Sse2Ops {
+    using V = __m128i;
+    static constexpr size_t Lanes = 2;
+    static V load(const uint64_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(uint64_t* p, V v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static V set1(uint64_t x) { return _mm_set1_epi64x(static_cast<long long>(x)); }
+    static V andV(V a, V b) { return _mm_and_si128(a, b); }
+    static V orV(V a, V b) { return _mm_or_si128(a, b); }
+    static V xorV(V a, V b) { return _mm_xor_si128(a, b); }
+    static V andNot(V a, V b) { return _mm_andnot_si128(a, b); }
+    static V shr1(V a) { return _mm_srli_epi64(a, 1); }
+    static V shl1(V a) { return _mm_slli_epi64(a, 1); }
+    static V shr63(V a) { return _mm_srli_epi64(a, 63); }
+    static V shl63(V a) { return _mm_slli_epi64(a, 63); }
+    static V shr32(V a) { return _mm_srli_epi64(a, 32); }
+    static V add64(V a, V b) { return _mm_add_epi64(a, b); }
+    static V mulLow32(V a, V b) { return _mm_mul_epu32(a, b); }
+};
+
+struct Sse2ByteOps {
+    using V = __m128i;
+    static constexpr size_t Lanes = 16;
+    static V load(const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(uint8_t* p, V v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static V set1(uint8_t x) { return _mm_set1_epi8(static_cast<char>(x)); }
+    static V andV(V a, V b) { return _mm_and_si128(a, b); }
+    static V orV(V a, V b) { return _mm_or_si128(a, b); }
+    static V andNot(V a, V b) { return _mm_andnot_si128(a, b); }
+    static V minU8(V a, V b) { return _mm_min_epu8(a, b); }
+    static V maxU8(V a, V b) { return _mm_max_epu8(a, b); }
+    static V eqU8(V a, V b) { return _mm_cmpeq_epi8(a, b); }
+    static V addU8(V a, V b) { return _mm_add_epi8(a, b); }
+    static V subU8(V a, V b) { return _mm_sub_epi8(a, b); }
+    static V halfU8(V a) { return _mm_and_si128(_mm_srli_epi16(a, 1), set1(0x7F)); }
+    static bool any(V a) { return _mm_movemask_epi8(a) != 0; }
+};
+
+struct Sse2PixelOps {
+    using V = __m128i;
+    static constexpr size_t Lanes = 4;
+    static V zero() { return _mm_setzero_si128(); }
+    static V widen(const uint8_t* p) {
+        int32_t bytes;
+        std::memcpy(&bytes, p, sizeof(bytes));
+        const __m128i v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), _mm_setzero_si128());
+        return _mm_unpacklo_epi16(v, _mm_setzero_si128());
+    }
+    static V absDiff(const uint8_t* a, const uint8_t* b) {
+        int32_t x, y;
+        std::memcpy(&x, a, sizeof(x));
+        std::memcpy(&y, b, sizeof(y));
+        const __m128i va = _mm_cvtsi32_si128(x), vb = _mm_cvtsi32_si128(y);
+        const __m128i d = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+        return _mm_unpacklo_epi16(_mm_unpacklo_epi8(d, _mm_setzero_si128()), _mm_setzero_si128());
+    }
+    static V load(const uint32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(uint32_t* p, V v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static V add(V a, V b) { return _mm_add_epi32(a, b); }
+    static V sub(V a, V b) { return _mm_sub_epi32(a, b); }
+    static V mul(V a, V b) { return _mm_madd_epi16(a, b); }
+    static uint64_t sumLanes(V a) {
+        alignas(16) uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), a);
+        return uint64_t{lanes[0]} + lanes[1] + lanes[2] + lanes[3];
+    }
+};
+
+// Every byte value broadcast to a register
+struct SplatTable {
+    __m128i v[256];
+    SplatTable() {
+        for (int b = 0; b < 256; b++) v[b] = _mm_set1_epi8(static_cast<char>(b));
+    }
+    const __m128i& operator[](size_t b) const { return v[b]; }
+};
+
+// Each block function decodes 16 characters if they are all valid symbols
+// (no whitespace) and returns false otherwise, leaving the output untouched.
+// SSE2 has no byte shuffle, so these use compares and 16-bit shifts where
+// the AVX2 versions use table lookups.
+
+bool asciiBitsBlock(const uint8_t* in, uint8_t* out) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    __m128i valid = _mm_cmpeq_epi8(_mm_andnot_si128(_mm_set1_epi8(1), v), _mm_set1_epi8('0'));
+    if (_mm_movemask_epi8(valid) != 0xFFFF) return false;
+
+    // Reverse each group of 8 (words, then the bytes in each word) so the
+    // first character lands in the top bit, then move every character's low
+    // bit into the sign bit
+    v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0x1B), 0x1B);
+    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_slli_epi64(v, 7)));
+    out[0] = static_cast<uint8_t>(mask);
+    out[1] = static_cast<uint8_t>(mask >> 8);
+    return true;
+}
+
+bool hexBlock(const uint8_t* in, uint8_t* out) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+
+    // Signed compares also reject bytes >= 0x80
+    __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                    _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), v));
+    __m128i isAlpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                    _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), lower));
+    if (_mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha)) != 0xFFFF) return false;
+
+    __m128i nibbles = _mm_or_si128(_mm_and_si128(isDigit, _mm_sub_epi8(v, _mm_set1_epi8('0'))),
+                                   _mm_andnot_si128(isDigit, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+
+    // (hi, lo) pairs -> hi * 16 + lo in 16-bit lanes, then pack to bytes
+    __m128i pairs = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0xFF)), 4),
+                                 _mm_srli_epi16(nibbles, 8));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(pairs, pairs));
+    return true;
+}
+
+bool base64Block(const uint8_t* in, uint8_t* out) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    auto range = [&](char low, char high) {
+        return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(low - 1))),
+                             _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(high + 1)), v));
+    };
+    __m128i upper = range('A', 'Z');
+    __m128i lower = range('a', 'z');
+    __m128i digit = range('0', '9');
+    __m128i plus = _mm_cmpeq_epi8(v, _mm_set1_epi8('+'));
+    __m128i slash = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+    __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(plus, slash)));
+    if (_mm_movemask_epi8(valid) != 0xFFFF) return false;
+
+    // Character to 6-bit value: the classes are disjoint, so their offsets
+    // can be or-ed together
+    __m128i offset = _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-65)),
+                                  _mm_and_si128(lower, _mm_set1_epi8(-71)));
+    offset = _mm_or_si128(offset, _mm_and_si128(digit, _mm_set1_epi8(4)));
+    offset = _mm_or_si128(offset, _mm_and_si128(plus, _mm_set1_epi8(19)));
+    offset = _mm_or_si128(offset, _mm_and_si128(slash, _mm_set1_epi8(16)));
+    __m128i values = _mm_add_epi8(v, offset);
+
+    // Four 6-bit values -> one 24-bit group per 32-bit lane
+    __m128i merged = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(values, _mm_set1_epi16(0xFF)), 6),
+                                  _mm_srli_epi16(values, 8));
+    merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+
+    alignas(16) uint32_t groups[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(groups), merged);
+    for (int k = 0; k < 4; k++) {
+        out[3 * k] = static_cast<uint8_t>(groups[k] >> 16);
+        out[3 * k + 1] = static_cast<uint8_t>(groups[k] >> 8);
+        out[3 * k + 2] = static_cast<uint8_t>(groups[k]);
+    }
+    return true;
+}
+
+} // namespace
+
+bool builtSse2() {
+    return true;
+}
+
+size_t elementarySse2(const uint64_t* in, uint64_t* out, size_t first, size_t last, uint8_t rule) {
+    static constexpr auto kernels = elementaryKernels<Sse2Ops>(std::make_index_sequence<256>{});
+    return kernels[rule](in, out, first, last);
+}
+
+size_t fingerprintSse2(const uint64_t* words, size_t first, size_t last, uint64_t offset,
+                       uint64_t& sum, uint64_t& mix) {
+    return fingerprintWords<Sse2Ops>(words, first, last, offset, sum, mix);
+}
+
+size_t mooreColumnsSse2(const uint64_t* up, const uint64_t* centre, const uint64_t* down,
+                        uint64_t* a0, uint64_t* a1, size_t first, size_t last) {
+    return sumColumns<Sse2Ops>(up, centre, down, a0, a1, first, last);
+}
+
+size_t mooreRuleSse2(const uint64_t* a0, const uint64_t* a1, const uint64_t* centre,
+                     uint64_t* out, size_t first, size_t last, const MooreRuleWords& rule) {
+    return applyRule<Sse2Ops>(a0, a1, centre, out, first, last, rule);
+}
+
+size_t medianRowSse2(const uint8_t* up, const uint8_t* centre, const uint8_t* down, uint8_t* out,
+                     size_t first, size_t last, bool& pending) {
+    return medianRow<Sse2ByteOps>(up, centre, down, out, first, last, pending);
+}
+
+size_t squaredErrorSse2(const uint8_t* a, const uint8_t* b, size_t first, size_t last, uint64_t& sum) {
+    return squaredError<Sse2PixelOps>(a, b, first, last, sum);
+}
+
+size_t slideMomentsSse2(const uint8_t* xIn, const uint8_t* yIn, const uint8_t* xOut, const uint8_t* yOut,
+                        uint32_t* moments, size_t stride, size_t first, size_t last) {
+    return slideMoments<Sse2PixelOps>(xIn, yIn, xOut, yOut, moments, stride, first, last);
+}
+
+// Running median over a two-level histogram kept as running totals in SSE
+// registers: lane j of binTotal counts the window bytes in 16-value bins
+// 0..j, and lane j of inBin[b] those in bin b that are <= 16b + j. Adding or
+// dropping a byte is a masked add on both, and the median's bin and value
+// are the numbers of lanes <= rank, read off compare masks, so the cost per
+// byte does not depend on the window or the data (counts fit a byte, as the
+// window is at most 255).
+size_t runningMedianSse2(const uint8_t* padded, uint8_t* out, size_t first, size_t last, size_t window) {
+    // Broadcasts come from a table: set1 is 4 instructions on SSE2
+    static const SplatTable splat;
+    const __m128i ramp = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i rank = splat[window / 2];
+    __m128i binTotal = _mm_setzero_si128();
+    __m128i inBin[16];
+    for (__m128i& row : inBin) row = _mm_setzero_si128();
+
+    // delta on the bin totals from v's bin up and on v's row from v up
+    auto add = [&](uint8_t v, __m128i delta) {
+        const __m128i binLanes = _mm_cmpgt_epi8(ramp, splat[((v >> 4) - 1) & 0xFF]);
+        const __m128i valueLanes = _mm_cmpgt_epi8(ramp, splat[((v & 15) - 1) & 0xFF]);
+        binTotal = _mm_add_epi8(binTotal, _mm_and_si128(binLanes, delta));
+        inBin[v >> 4] = _mm_add_epi8(inBin[v >> 4], _mm_and_si128(valueLanes, delta));
+    };
+    // Lanes <= rank (unsigned); totals rise along the row, so they are the
+    // low lanes and their count is the trailing ones of the compare mask
+    auto atMostRank = [&](__m128i totals) {
+        const __m128i le = _mm_cmpeq_epi8(_mm_min_epu8(totals, rank), totals);
+        return countTrailingZeros64(~static_cast<uint64_t>(_mm_movemask_epi8(le)));
+    };
+
+    const __m128i plus = splat[1], minus = splat[0xFF];
+    for (size_t j = 0; j < window; j++) add(padded[first + j], plus);
+    alignas(16) uint8_t totals[16];
+    for (size_t i = first; i < last; i++) {
+        if (i > first) {
+            add(padded[i + window - 1], plus);
+            add(padded[i - 1], minus);
+        }
+        const unsigned bin = atMostRank(binTotal);
+        _mm_store_si128(reinterpret_cast<__m128i*>(totals), binTotal);
+        const __m128i below = splat[bin > 0 ? totals[bin - 1] : 0];
+        out[i] = static_cast<uint8_t>(16 * bin + atMostRank(_mm_add_epi8(inBin[bin], below)));
+    }
+    return last;
+}
+
+size_t asciiBitsSse2(const uint8_t* text, uint8_t* out, size_t first, size_t last, size_t& bytes) {
+    size_t i = first;
+    for (; i + 16 <= last && asciiBitsBlock(text + i, out + bytes); i += 16) bytes += 2;
+    return i;
+}
+
+size_t hexSse2(const uint8_t* text, uint8_t* out, size_t first, size_t last, size_t& bytes) {
+    size_t i = first;
+    for (; i + 16 <= last && hexBlock(text + i, out + bytes); i += 16) bytes += 8;
+    return i;
+}
+
+size_t base64Sse2(const uint8_t* text, uint8_t* out, size_t first, size_t last, size_t& bytes) {
+    size_t i = first;
+    for (; i + 16 <= last && base64Block(text + i, out + bytes); i += 16) bytes += 12;
+    return i;
+}
+
+} // namespace simd_kernels
+
+#else
+
+namespace simd_kernels {
+
+bool builtSse2() {
+    return false;
+}
+
+size_t elementarySse2(const uint64_t*, uint64_t*, size_t first, size_t, uint8_t) {
+    return first;
+}
+
+size_t fingerprintSse2(const uint64_t*, size_t first, size_t, uint64_t, uint64_t&, uint64_t&) {
+    return first;
+}
+
+size_t mooreColumnsSse2(const uint64_t*, const uint64_t*, const uint64_t*,
+                        uint64_t*, uint64_t*, size_t first, size_t) {
+    return first;
+}
+
+size_t mooreRuleSse2(const uint64_t*, const uint64_t*, const uint64_t*,
+                     uint64_t*, size_t first, size_t, const MooreRuleWords&) {
+    return first;
+}
+
+size_t medianRowSse2(const uint8_t*, const uint8_t*, const uint8_t*, uint8_t*,
+                     size_t first, size_t, bool&) {
+    return first;
+}
+
+size_t squaredErrorSse2(const uint8_t*, const uint8_t*, size_t first, size_t, uint64_t&) {
+    return first;
+}
+
+size_t slideMomentsSse2(const uint8_t*, const uint8_t*, const uint8_t*, const uint8_t*,
+                        uint32_t*, size_t, size_t first, size_t) {
+    return first;
+}
+
+size_t runningMedianSse2(const uint8_t*, uint8_t*, size_t first, size_t, size_t) {
+    return first;
+}
+
+size_t asciiBitsSse2(const uint8_t*, uint8_t*, size_t first, size_t, size_t&) {
+    return first;
+}
+
+size_t hexSse2(const uint8_t*, uint8_t*, size_t first, size_t, size_t&) {
+    return first;
+}
+
+size_t base64Sse2(const uint8_t*, uint8_t*, size_t first, size_t, size_t&) {
+    return first;
+}
+
+} // namespace simd_kernels
+
+#endif
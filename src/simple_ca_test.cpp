@@ -115,18 +115,17 @@ int main(int argc, char** argv) {
         // Define CA rules to test
         std::vector<int> rules = {30, 82, 110, 150};
         
-        // Run CA with different rules and iterations
+        // Run CA with different rules, one evolution per rule with the
+        // results taken at each checkpoint iteration
         for (int rule : rules) {
-            for (int iterations : {1, 3, 5, 10}) {
-                std::cout << "\nApplying CA Rule " << rule << " with " << iterations << " iterations...\n";
-                
-                // Initialize CA processor
-                SimpleCellularAutomata ca(data, rule);
-                
-                // Apply CA iterations
-                for (int i = 0; i < iterations; i++) {
+            SimpleCellularAutomata ca(data, rule);
+            int iterations = 0;
+            for (int checkpoint : {1, 3, 5, 10}) {
+                // Advance to the next checkpoint
+                for (; iterations < checkpoint; iterations++) {
                     ca.update();
                 }
+                std::cout << "\nApplying CA Rule " << rule << " with " << iterations << " iterations...\n";
                 
                 // Get processed data
                 const auto& processedData = ca.getData();
@@ -10,7 +10,7 @@
 
 // For a more advanced pipeline, we might want to include "nist_sts.hpp" if needed.
 
-double StatAnalyzer::indexOfCoincidence(const std::vector<uint8_t>& data) {
+double StatAnalyzer::indexOfCoincidence(const ByteSpan& data) {
     if (data.size() < 2) return 0.0;
     std::vector<size_t> frequencies(256, 0);
     for (auto b : data) {
@@ -23,7 +23,7 @@ double StatAnalyzer::indexOfCoincidence(const std::vector<uint8_t>& data) {
     return sum / (data.size() * (data.size() - 1));
 }
 
-double StatAnalyzer::chiSquare(const std::vector<uint8_t>& data) {
+double StatAnalyzer::chiSquare(const ByteSpan& data) {
     if (data.empty()) return 0.0;
     double expected = double(data.size()) / 256.0;
     std::vector<size_t> frequencies(256, 0);
@@ -38,7 +38,7 @@ double StatAnalyzer::chiSquare(const std::vector<uint8_t>& data) {
     return chi;
 }
 
-double StatAnalyzer::serialCorrelation(const std::vector<uint8_t>& data) {
+double StatAnalyzer::serialCorrelation(const ByteSpan& data) {
     if (data.size() < 2) return 0.0;
     double mean = std::accumulate(data.begin(), data.end(), 0.0) / data.size();
     double num = 0.0, den1 = 0.0, den2 = 0.0;
@@ -53,7 +53,7 @@ double StatAnalyzer::serialCorrelation(const std::vector<uint8_t>& data) {
     return num / std::sqrt(den1 * den2);
 }
 
-void StatAnalyzer::byteFrequency(const std::vector<uint8_t>& data, bool showTopSpikes) {
+void StatAnalyzer::byteFrequency(const ByteSpan& data, bool showTopSpikes) {
     std::map<uint8_t, size_t> frequencies;
     for (auto b : data) {
         frequencies[b]++;
@@ -70,7 +70,7 @@ void StatAnalyzer::byteFrequency(const std::vector<uint8_t>& data, bool showTopS
     }
 }
 
-double StatAnalyzer::monobitTestPValue(const std::vector<uint8_t>& data) {
+double StatAnalyzer::monobitTestPValue(const ByteSpan& data) {
     if (data.empty()) return 0.0;
     size_t ones = 0;
     for (auto b : data) {
@@ -83,7 +83,7 @@ double StatAnalyzer::monobitTestPValue(const std::vector<uint8_t>& data) {
     return 2.0 * std::erfc(s_obs / std::sqrt(2.0));
 }
 
-void StatAnalyzer::displayStats(const std::string& label, const std::vector<uint8_t>& data) {
+void StatAnalyzer::displayStats(const std::string& label, const ByteSpan& data) {
     std::cout << "Statistics for " << label << ":\n";
     std::cout << "  Size: " << data.size() << " bytes\n";
     std::cout << "  Index of Coincidence: " << indexOfCoincidence(data) << "\n";
@@ -0,0 +1,96 @@
+// stream_analyzer.cpp
+#include "stream_analyzer.hpp"
+#include "ca_analyzer.hpp"
+#include "prefetch_reader.hpp"
+#include <fstream>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+StreamAnalyzer::StreamAnalyzer(const StreamOptions& options) : options(options) {
+    if (options.chunkBytes == 0) {
+        throw std::runtime_error("Stream chunk size must be positive");
+    }
+    if (options.iterations < 0) {
+        throw std::runtime_error("Iteration count must not be negative");
+    }
+}
+
+void StreamAnalyzer::run(const std::string& filename) {
+    // Disk reads run ahead on a background thread while the CA works on
+    // the current window
+    PrefetchReader file(filename, options.chunkBytes, options.prefetchDepth);
+
+    streamResults.clear();
+    streamResults.emplace_back();
+    streamResults.back().original = true;
+    for (int rule : options.caRules) {
+        StreamResult r;
+        r.rule = rule;
+        streamResults.push_back(std::move(r));
+    }
+
+    std::vector<std::unique_ptr<std::ofstream>> outputs;
+    if (!options.outputPrefix.empty()) {
+        for (int rule : options.caRules) {
+            std::string outName = options.outputPrefix + "_rule" + std::to_string(rule);
+            outputs.push_back(std::make_unique<std::ofstream>(outName, std::ios::binary));
+            if (!*outputs.back()) {
+                throw std::runtime_error("Cannot open output file: " + outName);
+            }
+        }
+    }
+
+    // window = [left halo | centre chunk | right halo]; the left halo is
+    // empty at the start of the file and the right one at the end
+    const size_t halo = static_cast<size_t>(options.iterations);
+    std::vector<uint8_t> window;
+    window.reserve(options.chunkBytes + 2 * halo);
+    size_t centreBegin = 0;
+    bool atEnd = false;
+
+    while (true) {
+        // Top up to a full centre plus right halo
+        size_t wanted = centreBegin + options.chunkBytes + halo;
+        if (!atEnd && window.size() < wanted) {
+            size_t have = window.size();
+            window.resize(wanted);
+            size_t got = file.read(window.data() + have, wanted - have);
+            window.resize(have + got);
+            atEnd = window.size() < wanted;
+        }
+
+        size_t centreEnd = atEnd ? window.size()
+                                 : centreBegin + options.chunkBytes;
+        if (centreEnd <= centreBegin) break;
+        size_t centreSize = centreEnd - centreBegin;
+
+        ByteSpan original = ByteSpan(window).subspan(centreBegin, centreSize);
+        streamResults[0].bits.add(original);
+        streamResults[0].bytes.add(original);
+
+        MultiRuleCAProcessor caProcessor(window.size(), options.caRules);
+        caProcessor.setThreads(options.threads);
+        caProcessor.setCycleDetection(options.detectCycles);
+        caProcessor.initializeFromCiphertext(window);
+        caProcessor.update(options.iterations);
+        for (size_t r = 0; r < options.caRules.size(); r++) {
+            ByteSpan centre = caProcessor.processedBytes(r).subspan(centreBegin, centreSize);
+
+            streamResults[r + 1].bits.add(centre);
+            streamResults[r + 1].bytes.add(centre);
+            if (!outputs.empty()) {
+                outputs[r]->write(reinterpret_cast<const char*>(centre.data()),
+                                  static_cast<std::streamsize>(centre.size()));
+            }
+        }
+
+        if (atEnd) break;
+
+        // Keep the last `halo` bytes of the centre as the next left halo,
+        // along with the lookahead already read
+        size_t keepFrom = centreEnd - std::min(halo, centreEnd);
+        window.erase(window.begin(), window.begin() + static_cast<std::ptrdiff_t>(keepFrom));
+        centreBegin = centreEnd - keepFrom;
+    }
+}
@@ -0,0 +1,48 @@
+// stream_analyzer.hpp
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "byte_stats.hpp"
+#include "nist_sts/stream_accumulator.hpp"
+
+// Bounded-memory analysis of inputs too large to load at once.
+//
+// The input is read in fixed-size chunks. Each chunk is run through the CA
+// together with `iterations` bytes of halo on either side: a byte's value
+// after k steps depends only on the k bytes around it, so the centre of each
+// window comes out exactly as it would from a whole-file run. The original
+// bytes and each rule's output then feed mergeable accumulators, so peak
+// memory is a few chunks no matter how large the file is. Chunks are
+// prefetched on a reader thread, so disk I/O overlaps with the CA work.
+struct StreamOptions {
+    size_t chunkBytes = size_t(16) << 20;
+    size_t prefetchDepth = 3;  // chunks read ahead of the analysis
+    int iterations = 5;
+    std::vector<int> caRules{30, 82, 110, 150};
+    unsigned threads = 0;      // CA worker threads, 0 = all cores
+    bool detectCycles = false; // skip generations past a cycle in a window
+    std::string outputPrefix;  // if set, processed data is written per rule
+};
+
+struct StreamResult {
+    bool original = false;  // the input itself rather than a CA rule's output
+    int rule = 0;
+    nist_sts::BitStreamAccumulator bits;
+    ByteStats bytes;
+};
+
+class StreamAnalyzer {
+public:
+    explicit StreamAnalyzer(const StreamOptions& options);
+
+    // Analyze a binary file; results()[0] holds the original data
+    void run(const std::string& filename);
+
+    const std::vector<StreamResult>& results() const { return streamResults; }
+
+private:
+    StreamOptions options;
+    std::vector<StreamResult> streamResults;
+};
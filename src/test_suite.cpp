@@ -16,10 +16,14 @@
 #include "nist_sts/tests/cumulative_sums_test.hpp"
 #include "nist_sts/tests/random_excursions_test.hpp"
 #include "nist_sts/tests/random_excursions_variant_test.hpp"
+#include "nist_sts/pattern_histogram.hpp"
+#include "worker_pool.hpp"
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
 #include <iostream>
+#include <stdexcept>
 
 namespace nist_sts {
 
@@ -56,6 +60,13 @@ TestResults TestSuite::testGenerator(RandomNumberGenerator& generator, size_t le
     return runTests(data);
 }
 
+std::vector<TestResults> TestSuite::testGeneratorStreams(RandomNumberGenerator& generator, size_t length,
+                                                        unsigned threads) {
+    // One generator run covers all streams, so they follow on from each other
+    BitSequence data = generator.generate(length * std::max<size_t>(1, params.numOfBitStreams));
+    return runStreamTests(data, threads);
+}
+
 std::map<std::string, TestResults> TestSuite::testAllGenerators(size_t length) {
     // This is a placeholder implementation
     // In a real scenario, you'd use a generator factory to create generators
@@ -73,19 +84,59 @@ void nist_sts::TestSuite::addTest(std::unique_ptr<StatisticalTest> test) {
     tests.push_back(std::move(test));
 }
 
+std::vector<nist_sts::TestResult> nist_sts::TestSuite::executeAll(const BitSequence& data) const {
+    size_t order = 0;
+    for (const auto& test : tests) {
+        order = std::max(order, test->patternOrder());
+    }
+    const PatternHistogram histogram = order > 0 ? PatternHistogram(data, order) : PatternHistogram();
+
+    std::vector<TestResult> results;
+    for (const auto& test : tests) {
+        results.push_back(test->patternOrder() > 0 ? test->executeWith(data, histogram)
+                                                   : test->execute(data));
+    }
+    return results;
+}
+
 // Run tests on bit sequence implementation
 nist_sts::TestResults nist_sts::TestSuite::runTests(const BitSequence& data) {
     TestResults results;
     results.data_size = data.size();
-    
-    for (const auto& test : tests) {
-        TestResult result = test->execute(data);
-        results.test_results.push_back(result);
+    results.test_results = executeAll(data);
+    return results;
+}
+
+std::vector<TestResults> nist_sts::TestSuite::runStreamTests(const BitSequence& data, unsigned threads) {
+    const size_t streamCount = params.numOfBitStreams;
+    if (streamCount == 0) {
+        throw std::runtime_error("Number of bitstreams must be positive");
+    }
+    const size_t streamLength = data.size() / streamCount;
+    if (streamLength == 0) {
+        throw std::runtime_error("Sequence too short for " + std::to_string(streamCount) + " bitstreams");
     }
     
+    // Tests keep no per-run state, so every worker shares the same instances
+    std::vector<TestResults> results(streamCount);
+    WorkerPool pool(threads);
+    runJobs(pool, streamCount, [&](size_t s) {
+        BitSequence stream = data.slice(s * streamLength, streamLength);
+        results[s].data_size = streamLength;
+        results[s].test_results = executeAll(stream);
+    });
     return results;
 }
 
+// Parameter management
+void nist_sts::TestSuite::setParameters(const TestParameters& newParams) {
+    params = newParams;
+}
+
+nist_sts::TestParameters nist_sts::TestSuite::getParameters() const {
+    return params;
+}
+
 // Generate a summary report implementation
 std::string nist_sts::TestSuite::generateSummary(const TestResults& results) const {
     std::stringstream ss;
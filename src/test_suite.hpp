@@ -15,6 +15,10 @@ class TestSuite {
 private:
     std::vector<std::unique_ptr<StatisticalTest>> tests;
     TestParameters params;
+
+    // Every test on `data`, the pattern tests from one histogram of the
+    // highest order they need
+    std::vector<TestResult> executeAll(const BitSequence& data) const;
     
 public:
     TestSuite();
@@ -32,6 +36,12 @@ public:
     TestResults runTests(const BitSequence& data);
     TestResults runTests(const std::string& filename, bool isAscii = true);
     
+    // Split `data` into params.numOfBitStreams consecutive streams of equal
+    // length (zero-copy slices; leftover bits are ignored) and run every
+    // test on each, `threads` streams at a time (0 = one per hardware thread).
+    // Results are in stream order; see SecondLevelAnalysis.
+    std::vector<TestResults> runStreamTests(const BitSequence& data, unsigned threads = 0);
+    
     // Default test suite creation - STATIC METHOD
     static TestSuite createDefaultSuite();
     
@@ -42,6 +52,10 @@ public:
     // Test a specific generator
     TestResults testGenerator(RandomNumberGenerator& generator, size_t length);
     
+    // Test params.numOfBitStreams generated streams of `length` bits each
+    std::vector<TestResults> testGeneratorStreams(RandomNumberGenerator& generator, size_t length,
+                                                  unsigned threads = 0);
+    
     // Test all available generators
     std::map<std::string, TestResults> testAllGenerators(size_t length);
 };
@@ -0,0 +1,72 @@
+#include "worker_pool.hpp"
+#include <algorithm>
+
+WorkerPool::WorkerPool(unsigned threads) : threadCount(threads) {}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    passStarted.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+WorkerPool& WorkerPool::operator=(const WorkerPool& other) {
+    threadCount = other.threadCount;
+    return *this;
+}
+
+unsigned WorkerPool::workersFor(size_t jobs) const {
+    unsigned workers = threadCount;
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(workers, jobs)));
+}
+
+void WorkerPool::run(unsigned workers, const std::function<void(unsigned)>& job) {
+    if (workers <= 1) {
+        job(0);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (threads.size() + 1 < workers) {
+            threads.emplace_back(&WorkerPool::loop, this, static_cast<unsigned>(threads.size() + 1));
+        }
+        task = &job;
+        active = workers;
+        running = static_cast<unsigned>(threads.size());
+        pass++;
+    }
+    passStarted.notify_all();
+    job(0);
+
+    // Every thread checks in, taking part or not, so none can still be
+    // reading `task` once this returns
+    std::unique_lock<std::mutex> lock(mutex);
+    passDone.wait(lock, [this] { return running == 0; });
+    task = nullptr;
+}
+
+void WorkerPool::loop(unsigned id) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        passStarted.wait(lock, [&] { return stopping || pass != seen; });
+        if (stopping) return;
+        seen = pass;
+        if (id < active) {
+            const std::function<void(unsigned)>* job = task;
+            lock.unlock();
+            (*job)(id);
+            lock.lock();
+        }
+        if (--running == 0) {
+            passDone.notify_one();
+        }
+    }
+}
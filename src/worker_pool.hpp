@@ -0,0 +1,90 @@
+// worker_pool.hpp
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker threads kept for the life of their owner and released once per
+// pass, so a CA update that makes many short passes over its grid does not
+// create and join threads for each one. The workers wait on a condition
+// variable between passes; run() hands them the pass and returns when all
+// of them are done with it, which is the barrier between passes.
+//
+// A pool belongs to one owner and is driven from one thread at a time.
+// Copies start with no workers of their own, so a copied owner never shares
+// threads with the original.
+class WorkerPool {
+public:
+    // Workers per pass; 0 (the default) uses every core
+    explicit WorkerPool(unsigned threads = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool& other) : WorkerPool(other.threadCount) {}
+    WorkerPool& operator=(const WorkerPool& other);
+
+    void setThreads(unsigned threads) { threadCount = threads; }
+
+    // Workers a pass of `jobs` jobs runs on: threadCount (or every core),
+    // at most one per job and at least one
+    unsigned workersFor(size_t jobs) const;
+
+    // Runs job(id) for every id in [0, workers), id 0 on the calling
+    // thread, starting threads the first time they are needed. The job
+    // must not throw.
+    void run(unsigned workers, const std::function<void(unsigned)>& job);
+
+private:
+    void loop(unsigned id);
+
+    unsigned threadCount;
+    std::vector<std::thread> threads;  // ids 1.. of the workers
+
+    std::mutex mutex;
+    std::condition_variable passStarted;
+    std::condition_variable passDone;
+    const std::function<void(unsigned)>* task = nullptr;
+    uint64_t pass = 0;       // passes started, so a worker sees each once
+    unsigned active = 0;     // workers taking part in the current pass
+    unsigned running = 0;    // threads still in the current pass
+    bool stopping = false;
+};
+
+// Runs job(t, scratch) for every t in [0, count) on the pool's workers,
+// which claim jobs from a shared counter, each with its own Scratch, and
+// returns the workers' Scratch objects. The first exception is rethrown
+// after all workers have stopped.
+template <typename Scratch, typename Job>
+std::vector<Scratch> runParallel(WorkerPool& pool, size_t count, Job job) {
+    const unsigned threads = pool.workersFor(count);
+    std::atomic<size_t> next{0};
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<Scratch> scratch(threads);
+
+    pool.run(threads, [&](unsigned id) {
+        try {
+            for (size_t t = next++; t < count; t = next++) {
+                job(t, scratch[id]);
+            }
+        } catch (...) {
+            errors[id] = std::current_exception();
+            next = count;
+        }
+    });
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+    return scratch;
+}
+
+// runParallel for jobs that need no scratch: job(t) for every t
+template <typename Job>
+void runJobs(WorkerPool& pool, size_t count, Job job) {
+    struct NoScratch {};
+    runParallel<NoScratch>(pool, count, [&](size_t t, NoScratch&) { job(t); });
+}